@@ -0,0 +1,357 @@
+#include "Arena.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "GameRecord.h"
+#include "Mcts.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
+#include "ThreadPool.h"
+
+namespace {
+// 95% 신뢰구간
+constexpr double kConfidenceZ = 1.96;
+
+struct Counters {
+    std::atomic<int> wins[GameState::kPlayerCount];
+    std::atomic<int> failures[GameState::kPlayerCount];
+    std::atomic<int> draws;
+    std::atomic<std::uint64_t> plies;
+
+    Counters() : draws(0), plies(0) {
+        for (auto& win : wins) {
+            win.store(0);
+        }
+        for (auto& failure : failures) {
+            failure.store(0);
+        }
+    }
+};
+
+// playGame의 반환값: 엔진이 규칙에 어긋난 수를 냈다 (좌석은 failedSeat)
+constexpr int kEngineFailure = -2;
+
+// 한 워커가 계속 다시 쓰는 좌석별 엔진 (좌석 설정에 맞는 쪽만 만든다)
+struct WorkerEngines {
+    std::vector<std::unique_ptr<AlphaBetaSearch>> alphaBeta;
+    std::vector<std::unique_ptr<MctsSearch>> monteCarlo;
+
+    SearchResult search(std::size_t seat, const GameState& state, const SearchLimits& limits) {
+        return alphaBeta[seat] ? alphaBeta[seat]->search(state, limits)
+                               : monteCarlo[seat]->search(state, limits);
+    }
+};
+
+// 게임 하나. 승자 좌석 또는 GameState::kNoWinner (무승부: 수 제한, 둘 수 없는 국면),
+// 엔진이 둘 수 없는 수를 내면 그 자리에서 멈추고 kEngineFailure (failedSeat에 그 좌석).
+// record가 있으면 둔 수를 기보 바이트로 덧붙인다.
+int playGame(const ArenaOptions& options, WorkerEngines& engines, const OpeningBook& book,
+             int gameIndex, int& plies, std::size_t& failedSeat, std::vector<std::uint8_t>* record) {
+    std::mt19937_64 random(options.seed * 0x9E3779B97F4A7C15ULL + static_cast<std::uint64_t>(gameIndex));
+    GameState state;
+    MoveList moves;
+
+    for (plies = 0; plies < options.maxPlies && !state.isGameOver(); ++plies) {
+        state.legalMoves(moves);
+        if (moves.empty()) {
+            return GameState::kNoWinner;
+        }
+
+        Move move;
+        if (plies < options.randomPlies) {
+            // 벽을 낭비하지 않도록 폰 이동 중에서만 고른다 (폰 이동은 목록 앞쪽에 모여 있다)
+            int pawnMoves = 0;
+            while (pawnMoves < moves.size() && !moves[pawnMoves].isWall()) {
+                ++pawnMoves;
+            }
+            const int count = pawnMoves > 0 ? pawnMoves : moves.size();
+            move = moves[static_cast<int>(random() % static_cast<std::uint64_t>(count))];
+        } else if (!book.probe(state, move)) {
+            const std::size_t seat = state.currentTurn();
+            const SearchResult result = engines.search(seat, state, options.seats[seat].limits);
+            move = result.bestMove;
+        }
+        if (state.apply(move) != MoveError::None) {
+            failedSeat = state.currentTurn();
+            return kEngineFailure;
+        }
+        if (record) {
+            record->push_back(record::encodeMove(move));
+        }
+    }
+    return state.winner();
+}
+
+// 윌슨 점수 구간
+void wilsonInterval(int successes, int trials, double& low, double& high) {
+    if (trials == 0) {
+        low = high = 0;
+        return;
+    }
+    const double n = trials;
+    const double p = successes / n;
+    const double z2 = kConfidenceZ * kConfidenceZ;
+    const double denominator = 1 + z2 / n;
+    const double center = (p + z2 / (2 * n)) / denominator;
+    const double margin = kConfidenceZ * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / denominator;
+    low = center - margin;
+    high = center + margin;
+}
+
+// "2" 또는 "2,2,3,2" 를 좌석별 값으로
+bool parseSeatValues(const std::string& text, std::array<long long, GameState::kPlayerCount>& values) {
+    std::vector<long long> parsed;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        char* end = nullptr;
+        const long long value = std::strtoll(part.c_str(), &end, 10);
+        if (part.empty() || *end != '\0' || value < 0) {
+            return false;
+        }
+        parsed.push_back(value);
+    }
+    if (parsed.size() == 1) {
+        values.fill(parsed[0]);
+        return true;
+    }
+    if (parsed.size() != values.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = parsed[i];
+    }
+    return true;
+}
+
+// "ab" 또는 "ab,nn,mcts,ab" (nn은 NNUE로 평가하는 alpha-beta)
+bool parseEngines(const std::string& text, ArenaOptions& options) {
+    std::vector<EngineSettings> engines;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        EngineSettings settings;
+        if (part == "ab" || part == "nn") {
+            settings.engine = EngineType::AlphaBeta;
+            settings.network = part == "nn";
+        } else if (part == "mcts") {
+            settings.engine = EngineType::MonteCarlo;
+        } else {
+            return false;
+        }
+        engines.push_back(settings);
+    }
+    if (engines.size() != 1 && engines.size() != options.seats.size()) {
+        return false;
+    }
+    for (std::size_t seat = 0; seat < options.seats.size(); ++seat) {
+        const EngineSettings& settings = engines.size() == 1 ? engines[0] : engines[seat];
+        options.seats[seat].engine = settings.engine;
+        options.seats[seat].network = settings.network;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cout << "usage: project2 arena [--games n] [--threads n] [--engine ab|mcts|nn[,...]]\n"
+              << "                      [--depth d[,d,d,d]] [--nodes n[,n,n,n]]\n"
+              << "                      [--time ms[,ms,ms,ms]] [--hash MB]\n"
+              << "                      [--random-plies n] [--max-plies n] [--seed n]\n"
+              << "                      [--record file] [--book file] [--eval file]\n";
+}
+}  // namespace
+
+ArenaOptions::ArenaOptions() {
+    for (EngineSettings& seat : seats) {
+        seat.limits.timeMillis = 0;
+        seat.limits.maxDepth = 2;
+    }
+}
+
+ArenaResult runArena(const ArenaOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+
+    // 망도 읽기만 하므로 모든 워커가 같이 쓴다
+    nnue::Network network;
+    bool hasNetwork = false;
+    if (!options.evalPath.empty()) {
+        hasNetwork = network.load(options.evalPath);
+        if (!hasNetwork) {
+            std::cout << "cannot open " << options.evalPath << '\n';
+        }
+    }
+
+    std::vector<WorkerEngines> engines(pool.size());
+    for (WorkerEngines& worker : engines) {
+        for (const EngineSettings& seat : options.seats) {
+            const bool monteCarlo = seat.engine == EngineType::MonteCarlo;
+            worker.alphaBeta.emplace_back(monteCarlo ? nullptr : new AlphaBetaSearch(seat.hashMegabytes));
+            worker.monteCarlo.emplace_back(monteCarlo ? new MctsSearch(seat.hashMegabytes) : nullptr);
+            if (!monteCarlo && seat.network && hasNetwork) {
+                worker.alphaBeta.back()->setNetwork(&network);
+            }
+        }
+    }
+
+    RecordWriter recorder;
+    if (!options.recordPath.empty() && !recorder.open(options.recordPath)) {
+        std::cout << "cannot open " << options.recordPath << '\n';
+    }
+    record::SeatKinds seats;
+    for (std::size_t seat = 0; seat < seats.size(); ++seat) {
+        seats[seat] = options.seats[seat].engine == EngineType::MonteCarlo ? record::kMonteCarlo
+                                                                            : record::kAlphaBeta;
+    }
+
+    // 읽기만 하므로 모든 워커가 같이 쓴다
+    OpeningBook book;
+    if (!options.bookPath.empty() && !book.open(options.bookPath)) {
+        std::cout << "cannot open " << options.bookPath << '\n';
+    }
+
+    Counters counters;
+    for (int game = 0; game < options.games; ++game) {
+        pool.submit([&options, &engines, &book, &counters, &recorder, &seats, game](int worker) {
+            int plies = 0;
+            std::size_t failedSeat = 0;
+            std::vector<std::uint8_t> bytes;
+            if (recorder.isOpen()) {
+                bytes.reserve(record::kHeaderSize + 2 + static_cast<std::size_t>(options.maxPlies));
+                record::appendHeader(bytes, seats);
+            }
+            const int winner = playGame(options, engines[worker], book, game, plies, failedSeat,
+                                        recorder.isOpen() ? &bytes : nullptr);
+            if (winner == kEngineFailure) {
+                // 끝까지 두지 못한 게임은 기보에 남기지 않는다
+                counters.failures[failedSeat].fetch_add(1, std::memory_order_relaxed);
+                counters.plies.fetch_add(static_cast<std::uint64_t>(plies), std::memory_order_relaxed);
+                return;
+            }
+            if (recorder.isOpen()) {
+                record::appendEnd(bytes, winner);
+                recorder.appendGame(bytes);
+            }
+            if (winner == GameState::kNoWinner) {
+                counters.draws.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                counters.wins[winner].fetch_add(1, std::memory_order_relaxed);
+            }
+            counters.plies.fetch_add(static_cast<std::uint64_t>(plies), std::memory_order_relaxed);
+        });
+    }
+    pool.wait();
+
+    ArenaResult result;
+    result.games = options.games;
+    result.draws = counters.draws.load();
+    for (std::size_t seat = 0; seat < result.wins.size(); ++seat) {
+        result.wins[seat] = counters.wins[seat].load();
+        result.failures[seat] = counters.failures[seat].load();
+    }
+    result.totalPlies = counters.plies.load();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int runArenaCommand(int argc, char** argv) {
+    ArenaOptions options;
+    for (int i = 0; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const std::string value = argv[++i];
+
+        std::array<long long, GameState::kPlayerCount> values;
+        bool ok = true;
+        if (option == "--games") {
+            options.games = std::atoi(value.c_str());
+            ok = options.games > 0;
+        } else if (option == "--threads") {
+            options.threads = std::atoi(value.c_str());
+            ok = options.threads > 0;
+        } else if (option == "--random-plies") {
+            options.randomPlies = std::atoi(value.c_str());
+            ok = options.randomPlies >= 0;
+        } else if (option == "--max-plies") {
+            options.maxPlies = std::atoi(value.c_str());
+            ok = options.maxPlies > 0;
+        } else if (option == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--hash") {
+            const int megabytes = std::atoi(value.c_str());
+            ok = megabytes > 0;
+            for (EngineSettings& seat : options.seats) {
+                seat.hashMegabytes = static_cast<std::size_t>(megabytes);
+            }
+        } else if (option == "--record") {
+            options.recordPath = value;
+        } else if (option == "--book") {
+            options.bookPath = value;
+        } else if (option == "--eval") {
+            options.evalPath = value;
+        } else if (option == "--engine") {
+            ok = parseEngines(value, options);
+        } else if (option == "--depth" || option == "--nodes" || option == "--time") {
+            ok = parseSeatValues(value, values);
+            for (std::size_t seat = 0; ok && seat < values.size(); ++seat) {
+                SearchLimits& limits = options.seats[seat].limits;
+                if (option == "--depth") {
+                    limits.maxDepth = static_cast<int>(values[seat]);
+                    ok = values[seat] > 0;
+                } else if (option == "--nodes") {
+                    limits.maxNodes = static_cast<std::uint64_t>(values[seat]);
+                } else {
+                    limits.timeMillis = static_cast<int>(values[seat]);
+                }
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+    for (const EngineSettings& seat : options.seats) {
+        if (seat.network && options.evalPath.empty()) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const ArenaResult result = runArena(options);
+
+    std::cout << "games " << result.games << " in " << result.seconds << " s ("
+              << result.games / std::max(result.seconds, 1e-9) << " games/s, "
+              << options.threads << " threads)\n"
+              << "average length " << static_cast<double>(result.totalPlies) / result.games
+              << " plies\n";
+    for (std::size_t seat = 0; seat < result.wins.size(); ++seat) {
+        double low, high;
+        wilsonInterval(result.wins[seat], result.games, low, high);
+        std::cout << "seat " << (seat + 1) << ": " << result.wins[seat] << " wins, "
+                  << 100.0 * result.wins[seat] / result.games << "% [" << 100 * low << "%, "
+                  << 100 * high << "%]\n";
+    }
+    std::cout << "draws " << result.draws << " (" << 100.0 * result.draws / result.games << "%)\n";
+    int failures = 0;
+    for (std::size_t seat = 0; seat < result.failures.size(); ++seat) {
+        if (result.failures[seat] > 0) {
+            std::cout << "seat " << (seat + 1) << ": " << result.failures[seat] << " illegal moves\n";
+            failures += result.failures[seat];
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "GameState.h"
+#include "Search.h"
+
+enum class EngineType {
+    AlphaBeta,
+    MonteCarlo
+};
+
+// 좌석 하나를 맡는 엔진 설정
+struct EngineSettings {
+    EngineType engine = EngineType::AlphaBeta;
+    SearchLimits limits;
+    std::size_t hashMegabytes = 1;  // 치환표 또는 MCTS 트리 크기
+    bool network = false;           // alpha-beta 잎 평가를 ArenaOptions::evalPath의 NNUE 망으로
+};
+
+struct ArenaOptions {
+    int games = 100;
+    int threads = 1;                 // 동시에 두는 게임 수
+    int randomPlies = 4;             // 게임마다 다른 출발을 위해 처음 몇 수는 무작위 폰 이동
+    int maxPlies = 400;              // 이 수를 넘기면 무승부
+    std::uint64_t seed = 1;
+    std::string recordPath;          // 비어 있지 않으면 모든 게임을 이진 기보로 덧붙인다
+    std::string bookPath;            // 무작위 수 다음부터 모든 좌석이 탐색 전에 찾아볼 오프닝 북
+    std::string evalPath;            // network 좌석이 쓰는 NNUE 망
+    std::array<EngineSettings, GameState::kPlayerCount> seats;
+
+    ArenaOptions();
+};
+
+struct ArenaResult {
+    int games = 0;
+    int draws = 0;
+    std::array<int, GameState::kPlayerCount> wins{};
+    // 엔진이 둘 수 없는 수를 내서 멈춘 게임 (그 수를 낸 좌석별). 승패와 무승부에 세지 않고 기보에도 남기지 않는다.
+    std::array<int, GameState::kPlayerCount> failures{};
+    std::uint64_t totalPlies = 0;
+    double seconds = 0;
+};
+
+// 게임 하나씩을 작업으로 만들어 작업 훔치기 풀에서 돌린다.
+// 작업끼리는 결과 카운터 말고는 공유하는 상태가 없다 (엔진은 워커마다 따로 둔다).
+ArenaResult runArena(const ArenaOptions& options);
+
+// "project2 arena [--games n] [--threads n] [--engine ab|mcts|nn] [--depth d] [--nodes n] [--record file] [--book file]
+//  [--eval file] ..." 명령. nn 좌석은 --eval 망으로 평가하는 alpha-beta다.
+int runArenaCommand(int argc, char** argv);
+
+#endif  // ARENA_HPP
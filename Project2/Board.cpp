@@ -1,14 +1,5 @@
 #include "Board.h"
 
-#include <algorithm>
-#include <iostream>
-#include <queue>
-#include <string>
-#include <utility>
-#include <vector>
-
-#include "Player.h"
-
 namespace {
 inline Position makePos(int r, int c){
     Position p;
@@ -16,331 +7,578 @@ inline Position makePos(int r, int c){
     p.col=c;
     return p;
 }
-constexpr const char* kResetColor = "\033[0m";
-constexpr const char* kRedColor = "\033[31m";
-constexpr const char* kGreenColor = "\033[32m";
-constexpr const char* kYellowColor = "\033[33m";
-constexpr const char* kBlueColor = "\033[34m";
-
-std::string colorize(const std::string& text, const char* color) {
-    return std::string(color) + text + kResetColor;
-}
 
-std::vector<std::pair<int, int>> wallPixels(const Position& position, bool horizontal) {
-    std::vector<std::pair<int, int>> pixels;
+// 크기별 상수 마스크. 전부 컴파일 시간에 만들어진다.
+template <int N>
+struct BoardMasks {
+    using WallMask = typename BasicBoard<N>::WallMask;
+    static constexpr int kWallGrid = N - 1;
 
-    const int centerRow = 2 + 2 * position.row;
-    const int centerCol = 4 + 4 * position.col;
-
-    pixels.emplace_back(centerRow, centerCol);
-    if (horizontal) {
-        pixels.emplace_back(centerRow, centerCol - 2);
-        pixels.emplace_back(centerRow, centerCol + 2);
-    } else {
-        pixels.emplace_back(centerRow - 1, centerCol);
-        pixels.emplace_back(centerRow + 1, centerCol);
+    static constexpr CellSet rowMask(int row) {
+        CellSet mask;
+        for (int c = 0; c < N; ++c) {
+            mask.set(row * N + c);
+        }
+        return mask;
     }
 
-    return pixels;
-}
-}  // namespace
-
-Board::Board() = default;
-
-void Board::reset() {
-    walls_.clear();
-}
-
-void Board::drawBoard(const std::vector<Player>& players) const {
-    const int N = kSize;                     // 예: 9
-    const int rows = 2 * N;                  // 0행 알파벳 + (셀/숫자)*반복
-    const int cols = 3 + N + (N - 1) * 5;    // "  " + N칸 + (N-1)*3
-
-    // 화면 버퍼 (전부 공백으로 초기화)
-    std::vector<std::vector<std::string>> screen(
-        rows, std::vector<std::string>(cols, " ")
-    );
-
-    const std::vector<std::pair<int, int>> highlightedCells = {
-        {2, 2}, {2, 6}, {6, 2}, {6, 6}
-    };
-
-    // 1) 맨 위 알파벳 줄 (A ~ H)
-    for (int g = 0; g < N - 1; ++g) {
-        int col = 6 + 6 * g; // 네모 사이 가운데 위치
-        if (col < cols) {
-            screen[0][col] = std::string(1, static_cast<char>('A' + g)); // A~H
+    static constexpr CellSet colMask(int col) {
+        CellSet mask;
+        for (int r = 0; r < N; ++r) {
+            mask.set(r * N + col);
         }
+        return mask;
     }
 
-    // 2) 기본 보드 (셀행 + 숫자행)
-    for (int r = 0; r < N; ++r) {
-        int cellRow = 1 + 2 * r;   // 셀행 (1,3,5,...)
-
-        // 셀행 앞 두 칸은 공백
-        screen[cellRow][0] = " ";
-        screen[cellRow][1] = " ";
-
-        // 셀 N개 출력
-        for (int c = 0; c < N; ++c) {
-            int cellCol = 3 + 6 * c; // 각 셀의 열 위치
-            if (cellCol < cols) {
-                bool highlight = std::any_of(
-                    highlightedCells.begin(),
-                    highlightedCells.end(),
-                    [&](const std::pair<int, int>& pos) {
-                        return pos.first == r && pos.second == c;
-                    });
-                screen[cellRow][cellCol] =
-                    highlight ? colorize(u8"□", kRedColor) : u8"□";
+    // 벽 슬롯 마스크. firstCol이 false면 열 0 슬롯을 뺀다 (좌우 시프트가 옆 줄로 넘어가는 것을 막는다)
+    static constexpr WallMask wallSlots(bool firstCol) {
+        WallMask mask{};
+        for (int row = 0; row < kWallGrid; ++row) {
+            for (int col = firstCol ? 0 : 1; col < kWallGrid; ++col) {
+                maskSet(mask, row * kWallGrid + col);
             }
         }
-
-        // 숫자행 (1~N-1까지만)
-        if (r < N - 1) {
-            int numRow = cellRow + 1;
-            screen[numRow][0]=" ";
-            screen[numRow][1] = std::to_string(r + 1); // 1,2,...,8
-        }
+        return mask;
     }
 
-    // 3) 플레이어 표시
-    const std::vector<const char*> playerColors = {
-        kYellowColor, kGreenColor, kRedColor, kBlueColor
+    static constexpr CellSet kAllCells = CellSet::firstN(N * N);
+    static constexpr CellSet kFirstRow = rowMask(0);
+    static constexpr CellSet kLastRow = rowMask(N - 1);
+    static constexpr CellSet kFirstCol = colMask(0);
+    static constexpr CellSet kLastCol = colMask(N - 1);
+    static constexpr WallMask kAllWallSlots = wallSlots(true);
+    static constexpr WallMask kNotFirstWallCol = wallSlots(false);
+
+    // GoalType 순서와 같다
+    static constexpr CellSet kGoalMasks[4] = {
+        kFirstRow, kLastRow, kFirstCol, kLastCol
     };
+};
 
-    for (std::size_t i = 0; i < players.size(); ++i) {
-        Position p = players[i].getPosition();
-        if (!isWithinBounds(p)) continue;
-
-        int cellRow = 1 + 2 * p.row;  // 셀행
-        int cellCol = 3 + 6 * p.col;  // 셀열
-
-        if (cellRow >= 0 && cellRow < rows &&
-            cellCol >= 0 && cellCol < cols) {
-            std::string symbol(1, static_cast<char>('1' + static_cast<int>(i)));
-            if (i < playerColors.size()) {
-                screen[cellRow][cellCol] = colorize(symbol, playerColors[i]);
-            } else {
-                screen[cellRow][cellCol] = symbol;
-            }
-        }
-    }
-
-    // 4) 벽 표시 (■)
-    for (const auto& wall : walls_) {
-        // 화면상 중심 좌표 계산
-        int centerRow = 2 + 2 * wall.position.row;  // 숫자 있는 줄 (2,4,6,...)
-        int centerCol = 6 + 6 * wall.position.col;  // 알파벳 있는 열 (4,8,12,...)
+template <int N> constexpr CellSet BoardMasks<N>::kAllCells;
+template <int N> constexpr CellSet BoardMasks<N>::kFirstRow;
+template <int N> constexpr CellSet BoardMasks<N>::kLastRow;
+template <int N> constexpr CellSet BoardMasks<N>::kFirstCol;
+template <int N> constexpr CellSet BoardMasks<N>::kLastCol;
+template <int N> constexpr typename BoardMasks<N>::WallMask BoardMasks<N>::kAllWallSlots;
+template <int N> constexpr typename BoardMasks<N>::WallMask BoardMasks<N>::kNotFirstWallCol;
+template <int N> constexpr CellSet BoardMasks<N>::kGoalMasks[4];
 
-        if (centerRow < 0 || centerRow >= rows ||
-            centerCol < 0 || centerCol >= cols)
-            continue;
+}  // namespace
 
-        // 중심 네모
-        screen[centerRow][centerCol] = colorize(u8"■", kBlueColor);
+template <int N> constexpr int BasicBoard<N>::kSize;
+template <int N> constexpr int BasicBoard<N>::kCellCount;
+template <int N> constexpr int BasicBoard<N>::kGoalCount;
+template <int N> constexpr int BasicBoard<N>::kUnreachable;
+template <int N> constexpr int BasicBoard<N>::kWallGrid;
+template <int N> constexpr int BasicBoard<N>::kWallSlotCount;
 
-        if (wall.horizontal) {
-            // 수평(h): 같은 행에서 양옆 셀 열에 찍어야 함
-            // 가운데(4+4c) 기준으로 ±2 하면 셀 열(2+4c, 6+4c)이 됨
-            int leftCol  = centerCol - 3;
-            int rightCol = centerCol + 3;
-            if (leftCol >= 0)    screen[centerRow][leftCol] = colorize(u8"■", kBlueColor);
-            if (rightCol < cols) screen[centerRow][rightCol] = colorize(u8"■", kBlueColor);
-        } else {
-            // 수직(v): 같은 열에서 위/아래 한 줄씩 (셀 줄)
-            // 가운데 숫자줄(2+2r) 기준으로 ±1 하면 위아래 셀줄(1+2r, 3+2r)
-            int upRow   = centerRow - 1;
-            int downRow = centerRow + 1;
-            if (upRow >= 0)    screen[upRow][centerCol] = colorize(u8"■", kBlueColor);
-            if (downRow < rows) screen[downRow][centerCol] = colorize(u8"■", kBlueColor);
-        }
-    }
+template <int N>
+BasicBoard<N>::BasicBoard() {
+    reset();
+}
 
-    // 5) 화면 출력 (가로 방향 칸 사이에 공백 추가)
-    for (int r = 0; r < rows; ++r) {
-        std::string line;
-        for (int c = 0; c < cols; ++c) {
-            line += screen[r][c];
-        }
-        std::cout << line << '\n';
+template <int N>
+void BasicBoard<N>::reset() {
+    horizontalWalls_ = WallMask{};
+    verticalWalls_ = WallMask{};
+    openEdges_[kNorth] = BoardMasks<N>::kAllCells & ~BoardMasks<N>::kFirstRow;
+    openEdges_[kSouth] = BoardMasks<N>::kAllCells & ~BoardMasks<N>::kLastRow;
+    openEdges_[kWest] = BoardMasks<N>::kAllCells & ~BoardMasks<N>::kFirstCol;
+    openEdges_[kEast] = BoardMasks<N>::kAllCells & ~BoardMasks<N>::kLastCol;
+
+    for (int goal = 0; goal < kGoalCount; ++goal) {
+        recomputeDistances(goal);
     }
+    components_.fill(0);
+    componentCount_ = 1;
 }
 
+template <int N>
+CellSet BasicBoard<N>::rowMask(int row) {
+    return BoardMasks<N>::rowMask(row);
+}
 
+template <int N>
+CellSet BasicBoard<N>::colMask(int col) {
+    return BoardMasks<N>::colMask(col);
+}
 
+template <int N>
+const CellSet BasicBoard<N>::kGoalMasks[BasicBoard<N>::kGoalCount] = {
+    BoardMasks<N>::kGoalMasks[0], BoardMasks<N>::kGoalMasks[1],
+    BoardMasks<N>::kGoalMasks[2], BoardMasks<N>::kGoalMasks[3]
+};
 
-bool Board::isWithinBounds(const Position& position) const {
+template <int N>
+bool BasicBoard<N>::isWithinBounds(const Position& position) const {
     return position.row >= 0 && position.row < kSize &&
            position.col >= 0 && position.col < kSize;
 }
 
-bool Board::overlapsExistingWall(const Position& position, bool horizontal) const {
-    const auto newPixels = wallPixels(position, horizontal);
+template <int N>
+bool BasicBoard<N>::isWallSlot(const Position& position) const {
+    return position.row >= 0 && position.row < kWallGrid &&
+           position.col >= 0 && position.col < kWallGrid;
+}
 
-    for (const auto& wall : walls_) {
-        const auto existingPixels = wallPixels(wall.position, wall.horizontal);
-        for (const auto& pixel : newPixels) {
-            if (std::find(existingPixels.begin(), existingPixels.end(), pixel) != existingPixels.end()) {
-                return true;
-            }
+template <int N>
+bool BasicBoard<N>::overlapsExistingWall(const Position& position, bool horizontal) const {
+    const WallMask bit = wallBit(position);
+
+    // 같은 중심점을 쓰는 벽(같은 슬롯 또는 교차)은 방향과 무관하게 겹침
+    if (!maskEmpty((horizontalWalls_ | verticalWalls_) & bit)) {
+        return true;
+    }
+
+    // 같은 방향으로 한 칸 옆 슬롯은 벽 절반이 겹침
+    WallMask neighbours{};
+    if (horizontal) {
+        if (position.col > 0) neighbours |= bit >> 1;
+        if (position.col < kWallGrid - 1) neighbours |= bit << 1;
+        return !maskEmpty(horizontalWalls_ & neighbours);
+    }
+    if (position.row > 0) neighbours |= bit >> kWallGrid;
+    if (position.row < kWallGrid - 1) neighbours |= bit << kWallGrid;
+    return !maskEmpty(verticalWalls_ & neighbours);
+}
+
+template <int N>
+void BasicBoard<N>::setWallEdges(const Position& position, bool horizontal, bool blocked) {
+    const int r = position.row;
+    const int c = position.col;
+
+    auto apply = [&](int row, int col, Direction direction) {
+        if (blocked) {
+            openEdges_[direction].reset(cellIndex(row, col));
+        } else {
+            openEdges_[direction].set(cellIndex(row, col));
         }
+    };
+
+    if (horizontal) {
+        // (r,c)~(r,c+1) 아래쪽 변을 막음
+        apply(r, c, kSouth);
+        apply(r, c + 1, kSouth);
+        apply(r + 1, c, kNorth);
+        apply(r + 1, c + 1, kNorth);
+    } else {
+        // (r,c)~(r+1,c) 오른쪽 변을 막음
+        apply(r, c, kEast);
+        apply(r + 1, c, kEast);
+        apply(r, c + 1, kWest);
+        apply(r + 1, c + 1, kWest);
     }
+}
 
-    return false;
+template <int N>
+bool BasicBoard<N>::canPlaceWall(const Position& position, bool horizontal) const {
+    return isWallSlot(position) && !overlapsExistingWall(position, horizontal);
 }
 
-bool Board::placeWall(const Position& position, bool horizontal) {
-    if (!isWithinBounds(position)) {
+template <int N>
+bool BasicBoard<N>::placeWall(const Position& position, bool horizontal) {
+    if (!canPlaceWall(position, horizontal)) {
         return false;
     }
 
-    if (position.row >= kSize - 1 || position.col >= kSize - 1) {
-        return false;
+    // 테두리나 다른 벽에 두 점 이상 닿아야 영역이 나뉠 수 있다 (벽을 놓기 전에 센다)
+    const bool maySplit = wallContactCount(position, horizontal) >= 2;
+    (horizontal ? horizontalWalls_ : verticalWalls_) |= wallBit(position);
+    setWallEdges(position, horizontal, true);
+    for (int goal = 0; goal < kGoalCount; ++goal) {
+        repairDistances(goal, position, horizontal, true);
     }
+    if (maySplit) {
+        relabelComponents();
+    }
+    return true;
+}
 
-    if (hasWall(position, horizontal)) {
+template <int N>
+bool BasicBoard<N>::hasWall(const Position& position, bool horizontal) const {
+    if (!isWallSlot(position)) {
         return false;
     }
+    return maskTest(horizontal ? horizontalWalls_ : verticalWalls_,
+                    position.row * kWallGrid + position.col);
+}
 
-    if (overlapsExistingWall(position, horizontal)) {
+template <int N>
+bool BasicBoard<N>::isMoveBlocked(const Position& from, const Position& to) const {
+    // 보드 밖으로 나가는 이동은 벽이 아니라 경계 검사에서 걸러진다
+    if (!isWithinBounds(from) || !isWithinBounds(to)) {
         return false;
     }
 
-    if (horizontal) {
-        Position left=makePos(position.row, position.col - 1);
-        Position right=makePos(position.row, position.col + 1);
-        if (position.col - 1 >= 0 && hasWall(left, true)) {
-            return false;
-        }
-        if (position.col + 1 < kSize - 1 && hasWall(right, true)) {
-            return false;
-        }
+    int rowDelta = to.row - from.row;
+    int colDelta = to.col - from.col;
+
+    Direction direction;
+    if (rowDelta == 1 && colDelta == 0) {
+        direction = kSouth;
+    } else if (rowDelta == -1 && colDelta == 0) {
+        direction = kNorth;
+    } else if (rowDelta == 0 && colDelta == 1) {
+        direction = kEast;
+    } else if (rowDelta == 0 && colDelta == -1) {
+        direction = kWest;
     } else {
-        Position up=makePos(position.row - 1, position.col);
-        Position down=makePos(position.row + 1, position.col);
-        if (position.row - 1 >= 0 && hasWall(up, false)) {
-            return false;
-        }
-        if (position.row + 1 < kSize - 1 && hasWall(down, false)) {
-            return false;
-        }
+        return false;
     }
 
-    walls_.push_back({position, horizontal});
-    return true;
+    return !openEdges_[direction].test(cellIndex(from.row, from.col));
 }
 
-bool Board::hasWall(const Position& position, bool horizontal) const {
-    return std::any_of(walls_.begin(), walls_.end(),
-                       [&](const WallPlacement& wall) {
-                           return wall.horizontal == horizontal &&
-                                  wall.position.row == position.row &&
-                                  wall.position.col == position.col;
-                       });
-}
+template <int N>
+void BasicBoard<N>::removeWall(const Position& position, bool horizontal) {
+    if (!hasWall(position, horizontal)) {
+        return;
+    }
 
-bool Board::isMoveBlocked(const Position& from, const Position& to) const {
-    int rowDelta = to.row - from.row;
-    int colDelta = to.col - from.col;
+    (horizontal ? horizontalWalls_ : verticalWalls_) &= ~wallBit(position);
+    setWallEdges(position, horizontal, false);
+    for (int goal = 0; goal < kGoalCount; ++goal) {
+        repairDistances(goal, position, horizontal, false);
+    }
+    // 벽 양쪽이 이미 같은 요소였으면 합쳐질 것이 없다
+    const int first = cellIndex(position.row, position.col);
+    const int across = horizontal ? first + kSize : first + 1;
+    const int next = horizontal ? first + 1 : first + kSize;
+    const int nextAcross = horizontal ? next + kSize : next + 1;
+    if (components_[first] != components_[across] || components_[next] != components_[nextAcross]) {
+        relabelComponents();
+    }
+}
 
-    if (rowDelta == 1 && colDelta == 0) {
-        if (hasWall(makePos(from.row, from.col), true)) {
-            return true;
+template <int N>
+void BasicBoard<N>::relabelComponents() {
+    CellSet remaining = BoardMasks<N>::kAllCells;
+    int label = 0;
+    while (remaining.any()) {
+        CellSet reached = CellSet::single(remaining.lowest());
+        CellSet frontier = reached;
+        while (frontier.any()) {
+            frontier = expand(frontier) & ~reached;
+            reached |= frontier;
         }
-        if (from.col - 1 >= 0 && hasWall(makePos(from.row, from.col-1), true)) {
-            return true;
+        remaining &= ~reached;
+        while (reached.any()) {
+            components_[reached.popLowest()] = static_cast<std::uint8_t>(label);
         }
-        return false;
+        ++label;
     }
-    if (rowDelta == -1 && colDelta == 0) {
-        if (hasWall(makePos(to.row, to.col), true)) {
-            return true;
+    componentCount_ = label;
+}
+
+template <int N>
+void BasicBoard<N>::recomputeDistances(int goal) {
+    DistanceMap& map = distances_[goal];
+    map.distance.fill(static_cast<std::uint8_t>(kUnreachable));
+
+    CellSet frontier = BoardMasks<N>::kGoalMasks[goal];
+    CellSet reached = frontier;
+    int level = 0;
+    while (frontier.any()) {
+        map.levels[level] = frontier;
+        CellSet ring = frontier;
+        while (ring.any()) {
+            map.distance[ring.popLowest()] = static_cast<std::uint8_t>(level);
         }
-        if (to.col - 1 >= 0 && hasWall(makePos(to.row, to.col - 1), true)) {
-            return true;
+        frontier = expand(frontier) & ~reached;
+        reached |= frontier;
+        ++level;
+    }
+    map.levels[level] = CellSet();
+    map.levelCount = level;
+}
+
+// 벽 하나가 바꾸는 변은 두 개뿐이다. 그 변의 가까운 끝점 거리(startLevel) 이하인 셀은
+// 거리가 변하지 않으므로 BFS를 startLevel 링에서 다시 시작하고, 새 링이 예전 링과
+// 같아지는 순간(지금까지 도달한 집합도 같을 때) 멈춘다. 거리 값은 바뀐 셀만 다시 쓴다.
+template <int N>
+void BasicBoard<N>::repairDistances(int goal, const Position& position, bool horizontal, bool blocked) {
+    DistanceMap& map = distances_[goal];
+    const int r = position.row;
+    const int c = position.col;
+    const int edges[2][2] = {
+        {cellIndex(r, c), horizontal ? cellIndex(r + 1, c) : cellIndex(r, c + 1)},
+        {horizontal ? cellIndex(r, c + 1) : cellIndex(r + 1, c), cellIndex(r + 1, c + 1)}
+    };
+
+    CellSet edgeCells;
+    int startLevel = kUnreachable;
+    for (const auto& edge : edges) {
+        edgeCells.set(edge[0]);
+        edgeCells.set(edge[1]);
+        const int a = map.distance[edge[0]];
+        const int b = map.distance[edge[1]];
+        // 막을 때는 최단 경로에 쓰이던 변(차이 1)만, 열 때는 차이가 2 이상인 변만 영향이 있다
+        const int gap = a > b ? a - b : b - a;
+        const bool affects = blocked ? gap == 1 : gap >= 2;
+        if (affects) {
+            const int nearer = a < b ? a : b;
+            if (nearer < startLevel) startLevel = nearer;
         }
-        return false;
     }
-    if (rowDelta == 0 && colDelta == 1) {
-        if (hasWall(makePos(from.row, from.col), false)) {
-            return true;
+    if (startLevel == kUnreachable) {
+        return;
+    }
+
+    CellSet reachedOld;
+    for (int level = 0; level <= startLevel; ++level) {
+        reachedOld |= map.levels[level];
+    }
+    CellSet reachedNew = reachedOld;
+    CellSet frontier = map.levels[startLevel];
+
+    for (int level = startLevel + 1;; ++level) {
+        const CellSet next = expand(frontier) & ~reachedNew;
+        const CellSet old = level < map.levelCount ? map.levels[level] : CellSet();
+        reachedOld |= old;
+        reachedNew |= next;
+
+        if (next.none()) {
+            // BFS가 끝났다. 예전에 닿던 셀 중 이번에 못 닿은 셀은 목표와 끊어졌다
+            for (int rest = level + 1; rest < map.levelCount; ++rest) {
+                reachedOld |= map.levels[rest];
+            }
+            CellSet lost = reachedOld & ~reachedNew;
+            while (lost.any()) {
+                map.distance[lost.popLowest()] = static_cast<std::uint8_t>(kUnreachable);
+            }
+            map.levels[level] = next;
+            map.levelCount = level;
+            return;
         }
-        if (from.row - 1 >= 0 && hasWall(makePos(from.row - 1, from.col), false)) {
-            return true;
+        // 바뀐 변의 양 끝이 모두 이미 도달한 셀이면 그 변은 더 이상 BFS에 쓰이지 않으므로
+        // 링과 도달 집합이 예전과 같아진 순간 이후 링도 전부 같다
+        if (next == old && reachedNew == reachedOld && (edgeCells & ~reachedNew).none()) {
+            return;
         }
-        return false;
-    }
-    if (rowDelta == 0 && colDelta == -1) {
-        if (hasWall(makePos(to.row, to.col), false)) {
-            return true;
+
+        CellSet changed = next & ~old;
+        while (changed.any()) {
+            map.distance[changed.popLowest()] = static_cast<std::uint8_t>(level);
         }
-        if (to.row - 1 >= 0 && hasWall(makePos(to.row - 1, to.col), false)) {
+        map.levels[level] = next;
+        frontier = next;
+    }
+}
+
+template <int N>
+CellSet BasicBoard<N>::expand(const CellSet& frontier,
+                      const std::array<CellSet, kDirectionCount>& openEdges) {
+    return (frontier & openEdges[kSouth]).shiftUp(kSize) |
+           (frontier & openEdges[kNorth]).shiftDown(kSize) |
+           (frontier & openEdges[kEast]).shiftUp(1) |
+           (frontier & openEdges[kWest]).shiftDown(1);
+}
+
+template <int N>
+bool BasicBoard<N>::reaches(const CellSet& start, const CellSet& goal,
+                    const std::array<CellSet, kDirectionCount>& openEdges) {
+    // 프런티어 전체를 시프트로 한 번에 확장하는 flood fill
+    CellSet reached = start;
+    CellSet frontier = reached;
+
+    while (frontier.any()) {
+        if (reached.intersects(goal)) {
             return true;
         }
-        return false;
+        frontier = expand(frontier, openEdges) & ~reached;
+        reached |= frontier;
     }
 
     return false;
 }
 
-void Board::removeWall(const Position& position, bool horizontal) {
-    auto it = std::find_if(walls_.begin(), walls_.end(),
-                           [&](const WallPlacement& wall) {
-                               return wall.horizontal == horizontal &&
-                                      wall.position.row == position.row &&
-                                      wall.position.col == position.col;
-                           });
-    if (it != walls_.end()) {
-        walls_.erase(it);
+template <int N>
+bool BasicBoard<N>::existsPath(const Position& start, const CellSet& goal) const {
+    if (!isWithinBounds(start)) {
+        return false;
     }
+    return reaches(cellMask(start), goal, openEdges_);
 }
 
-bool Board::existsPath(const Position& start,
-                       const std::function<bool(const Position&)>& isGoal) const {
-    if (!isWithinBounds(start)) {
-        return false;
+template <int N>
+void BasicBoard<N>::freeWallSlots(WallMask& horizontal, WallMask& vertical) const {
+    // 같은 중심점, 또는 같은 방향으로 한 칸 옆 슬롯에 벽이 있으면 겹친다
+    const WallMask centers = horizontalWalls_ | verticalWalls_;
+    horizontal = ~(centers |
+                   ((horizontalWalls_ << 1) & BoardMasks<N>::kNotFirstWallCol) |
+                   ((horizontalWalls_ >> 1) & (BoardMasks<N>::kNotFirstWallCol >> 1)));
+    vertical = ~(centers | (verticalWalls_ << kWallGrid) | (verticalWalls_ >> kWallGrid));
+    horizontal &= BoardMasks<N>::kAllWallSlots;
+    vertical &= BoardMasks<N>::kAllWallSlots;
+}
+
+// 벽의 격자점 세 개(양 끝과 가운데) 중 보드 테두리나 다른 벽에 닿는 점의 수.
+// 한 점 이하로만 닿는 벽은 새 닫힌 영역을 만들 수 없으므로 경로를 끊지 못한다.
+template <int N>
+int BasicBoard<N>::wallContactCount(const Position& position, bool horizontal) const {
+    auto hasH = [&](int row, int col) {
+        return row >= 0 && row < kWallGrid && col >= 0 && col < kWallGrid &&
+               maskTest(horizontalWalls_, row * kWallGrid + col);
+    };
+    auto hasV = [&](int row, int col) {
+        return row >= 0 && row < kWallGrid && col >= 0 && col < kWallGrid &&
+               maskTest(verticalWalls_, row * kWallGrid + col);
+    };
+    // 격자점 (pr, pc)는 0..kSize 범위, 셀 (pr-1..pr, pc-1..pc)의 꼭짓점
+    auto touched = [&](int pr, int pc) {
+        if (pr == 0 || pr == kSize || pc == 0 || pc == kSize) {
+            return true;
+        }
+        return hasH(pr - 1, pc - 2) || hasH(pr - 1, pc - 1) || hasH(pr - 1, pc) ||
+               hasV(pr - 2, pc - 1) || hasV(pr - 1, pc - 1) || hasV(pr, pc - 1);
+    };
+
+    const int r = position.row;
+    const int c = position.col;
+    int contacts = 0;
+    if (horizontal) {
+        contacts += touched(r + 1, c) ? 1 : 0;
+        contacts += touched(r + 1, c + 1) ? 1 : 0;
+        contacts += touched(r + 1, c + 2) ? 1 : 0;
+    } else {
+        contacts += touched(r, c + 1) ? 1 : 0;
+        contacts += touched(r + 1, c + 1) ? 1 : 0;
+        contacts += touched(r + 2, c + 1) ? 1 : 0;
     }
+    return contacts;
+}
 
-    if (isGoal(start)) {
+template <int N>
+bool BasicBoard<N>::wallKeepsPaths(const Position& position, bool horizontal,
+                           const Position* starts, const GoalType* goals, int count) const {
+    // 이미 길이 끊긴 플레이어가 있으면 어떤 벽을 놓아도 "모두 닿는다"가 될 수 없다
+    for (int i = 0; i < count; ++i) {
+        if (distanceToGoal(starts[i], goals[i]) == kUnreachable) {
+            return false;
+        }
+    }
+    if (wallContactCount(position, horizontal) < 2) {
         return true;
     }
 
-    std::vector<std::vector<bool>> visited(
-        kSize, std::vector<bool>(kSize, false));
-    std::queue<Position> searchQueue;
+    std::array<CellSet, kDirectionCount> open = openEdges_;
+    closeWallEdges(position, horizontal, open);
+    for (int i = 0; i < count; ++i) {
+        if (!reaches(cellMask(starts[i]), goalMask(goals[i]), open)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+void BasicBoard<N>::closeWallEdges(const Position& position, bool horizontal,
+                                   std::array<CellSet, kDirectionCount>& openEdges) {
+    const int r = position.row;
+    const int c = position.col;
+    if (horizontal) {
+        openEdges[kSouth].reset(cellIndex(r, c));
+        openEdges[kSouth].reset(cellIndex(r, c + 1));
+        openEdges[kNorth].reset(cellIndex(r + 1, c));
+        openEdges[kNorth].reset(cellIndex(r + 1, c + 1));
+    } else {
+        openEdges[kEast].reset(cellIndex(r, c));
+        openEdges[kEast].reset(cellIndex(r + 1, c));
+        openEdges[kWest].reset(cellIndex(r, c + 1));
+        openEdges[kWest].reset(cellIndex(r + 1, c + 1));
+    }
+}
 
-    visited[start.row][start.col] = true;
-    searchQueue.push(start);
+template <int N>
+void BasicBoard<N>::addBlockingSlots(int cell, Direction direction, WallMask& horizontal, WallMask& vertical) {
+    // 가로 벽 (r, c)는 (r, c), (r, c+1)의 남쪽 변을, 세로 벽 (r, c)는 (r, c), (r+1, c)의 동쪽 변을 막는다
+    int row = cell / kSize;
+    int col = cell % kSize;
+    if (direction == kNorth) --row;
+    if (direction == kWest) --col;
+    const bool verticalStep = direction == kNorth || direction == kSouth;
+    WallMask& slots = verticalStep ? horizontal : vertical;
+    for (int offset = -1; offset <= 0; ++offset) {
+        const int slotRow = verticalStep ? row : row + offset;
+        const int slotCol = verticalStep ? col + offset : col;
+        if (slotRow >= 0 && slotRow < kWallGrid && slotCol >= 0 && slotCol < kWallGrid) {
+            maskSet(slots, slotRow * kWallGrid + slotCol);
+        }
+    }
+}
 
-    const int directions[4][2] = {
-        {1, 0}, {-1, 0}, {0, 1}, {0, -1}
-    };
+template <int N>
+void BasicBoard<N>::pathWallSlots(const Position& start, GoalType goal,
+                                  WallMask& horizontal, WallMask& vertical) const {
+    const DistanceMap& map = distances_[static_cast<int>(goal)];
+    int cell = cellIndex(start);
+    if (map.distance[cell] == kUnreachable) {
+        horizontal = vertical = BoardMasks<N>::kAllWallSlots;
+        return;
+    }
 
-    while (!searchQueue.empty()) {
-        Position current = searchQueue.front();
-        searchQueue.pop();
+    horizontal = vertical = WallMask{};
+    // 거리가 하나씩 줄어드는 이웃으로 내려가면 목표에 닿는다
+    while (map.distance[cell] != 0) {
+        for (int d = 0; d < kDirectionCount; ++d) {
+            const Direction direction = static_cast<Direction>(d);
+            if (canStep(cell, direction) && map.distance[stepCell(cell, direction)] + 1 == map.distance[cell]) {
+                addBlockingSlots(cell, direction, horizontal, vertical);
+                cell = stepCell(cell, direction);
+                break;
+            }
+        }
+    }
+}
 
-        if (isGoal(current)) {
-            return true;
+template <int N>
+void BasicBoard<N>::legalWallSlots(const Position* starts, const GoalType* goals, int count,
+                                   WallMask& horizontal, WallMask& vertical) const {
+    // 이미 길이 끊긴 플레이어가 있으면 놓을 수 있는 벽이 없다 (wallKeepsPaths와 같은 판정)
+    for (int i = 0; i < count; ++i) {
+        if (distanceToGoal(starts[i], goals[i]) == kUnreachable) {
+            horizontal = vertical = WallMask{};
+            return;
         }
+    }
+    freeWallSlots(horizontal, vertical);
+
+    WallMask touched[2][kGoalCount];
+    WallMask touchedAny[2] = {WallMask{}, WallMask{}};
+    for (int i = 0; i < count; ++i) {
+        pathWallSlots(starts[i], goals[i], touched[0][i], touched[1][i]);
+        touchedAny[0] |= touched[0][i];
+        touchedAny[1] |= touched[1][i];
+    }
 
-        for (const auto& dir : directions) {
-            Position next=makePos(current.row + dir[0], current.col + dir[1]);
-            if (!isWithinBounds(next)) {
-                continue;
-            }
-            if (visited[next.row][next.col]) {
+    // 어느 경로도 건드리지 않는 벽은 모두의 경로를 그대로 남긴다
+    WallMask* result[2] = {&horizontal, &vertical};
+    for (int orientation = 0; orientation < 2; ++orientation) {
+        const bool isHorizontal = orientation == 0;
+        WallMask risky = *result[orientation] & touchedAny[orientation];
+        while (!maskEmpty(risky)) {
+            const int index = maskPopLowest(risky);
+            const Position position = makePos(index / kWallGrid, index % kWallGrid);
+            if (wallContactCount(position, isHorizontal) < 2) {
                 continue;
             }
-            if (isMoveBlocked(current, next)) {
-                continue;
+            std::array<CellSet, kDirectionCount> open = openEdges_;
+            closeWallEdges(position, isHorizontal, open);
+            for (int i = 0; i < count; ++i) {
+                if (maskTest(touched[orientation][i], index) &&
+                    !reaches(cellMask(starts[i]), goalMask(goals[i]), open)) {
+                    WallMask bit{};
+                    maskSet(bit, index);
+                    *result[orientation] &= ~bit;
+                    break;
+                }
             }
-
-            visited[next.row][next.col] = true;
-            searchQueue.push(next);
         }
     }
-
-    return false;
 }
+
+template class BasicBoard<5>;
+template class BasicBoard<7>;
+template class BasicBoard<9>;
+template class BasicBoard<11>;
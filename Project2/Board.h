@@ -2,39 +2,171 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
-#include <functional>
-#include <vector>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 
+#include "CellSet.h"
 #include "Position.h"
 
-class Player;
+// 플레이어가 도달해야 하는 가장자리
+enum class GoalType {
+    Row0,
+    RowLast,
+    Col0,
+    ColLast
+};
 
-class Board {
+// N x N 보드. 크기마다 따로 인스턴스화되므로 경계, 가장자리 마스크, 시프트 폭이 모두 상수다.
+// Board.cpp에서 5, 7, 9, 11을 명시적으로 인스턴스화한다 (셀은 CellSet 128칸에 들어가야 한다).
+template <int N>
+class BasicBoard {
 public:
-    static constexpr int kSize = 9;
+    static constexpr int kSize = N;
+    static constexpr int kCellCount = kSize * kSize;
+    static constexpr int kGoalCount = 4;
+    static constexpr int kUnreachable = 0xFF;
+    // 벽 슬롯은 (kSize-1)x(kSize-1) 격자. 슬롯 번호는 가로 먼저, 그다음 세로 (9x9: 0..63, 64..127)
+    static constexpr int kWallGrid = kSize - 1;
+    static constexpr int kWallSlotCount = 2 * kWallGrid * kWallGrid;
+
+    static_assert(N % 2 == 1 && N >= 5, "board size must be odd and at least 5");
+    static_assert(kCellCount <= 128, "cells must fit in a CellSet");
+
+    // 한 방향 벽 슬롯 집합. 9x9까지는 64비트 하나로 충분하다.
+    using WallMask = typename std::conditional<kWallGrid * kWallGrid <= 64, std::uint64_t, CellSet>::type;
 
-    Board();
+    BasicBoard();
 
     void reset();
-    void drawBoard(const std::vector<Player>& players) const;
 
     bool isWithinBounds(const Position& position) const;
+    bool isWallSlot(const Position& position) const;
+    bool canPlaceWall(const Position& position, bool horizontal) const;
     bool placeWall(const Position& position, bool horizontal);
     bool hasWall(const Position& position, bool horizontal) const;
     bool isMoveBlocked(const Position& from, const Position& to) const;
-    bool existsPath(const Position& start,
-                    const std::function<bool(const Position&)>& isGoal) const;
+    bool existsPath(const Position& start, const CellSet& goal) const;
     void removeWall(const Position& position, bool horizontal);
 
-private:
-    struct WallPlacement {
+    static int cellIndex(int row, int col) { return row * kSize + col; }
+    static int cellIndex(const Position& position) { return cellIndex(position.row, position.col); }
+    static Position cellPosition(int cell) {
+        Position position;
+        position.row = cell / kSize;
+        position.col = cell % kSize;
+        return position;
+    }
+    static int wallSlot(const Position& position, bool horizontal) {
+        return (horizontal ? 0 : kWallGrid * kWallGrid) + position.row * kWallGrid + position.col;
+    }
+    static bool isHorizontalSlot(int slot) { return slot < kWallGrid * kWallGrid; }
+    static Position wallSlotPosition(int slot) {
+        const int index = slot % (kWallGrid * kWallGrid);
         Position position;
-        bool horizontal;
+        position.row = index / kWallGrid;
+        position.col = index % kWallGrid;
+        return position;
+    }
+    static CellSet cellMask(const Position& position) {
+        return CellSet::single(cellIndex(position.row, position.col));
+    }
+    static CellSet rowMask(int row);
+    static CellSet colMask(int col);
+    // 목표 가장자리 셀 집합. 헤더에 두어 도착 검사가 표 읽기와 비트 검사로 인라인된다.
+    static const CellSet& goalMask(GoalType goal) { return kGoalMasks[static_cast<int>(goal)]; }
+    static bool isGoalCell(int cell, GoalType goal) { return goalMask(goal).test(cell); }
+
+    // 벽으로 나뉜 연결 요소 번호. 벽을 놓거나 치울 때 나뉘거나 합쳐질 수 있을 때만 다시 매긴다.
+    int componentOf(int cell) const { return components_[cell]; }
+    int componentCount() const { return componentCount_; }
+    // 두 셀 사이에 (폰을 무시하고) 길이 있는지. existsPath(셀 하나)와 같지만 번호 비교 한 번이다.
+    bool connected(int a, int b) const { return components_[a] == components_[b]; }
+
+    // 벽만 고려한 최단 거리 (도달 불가면 kUnreachable). 벽을 놓거나 치울 때마다 증분 갱신된다.
+    int distanceToGoal(const Position& position, GoalType goal) const {
+        return distanceToGoal(cellIndex(position.row, position.col), goal);
+    }
+    int distanceToGoal(int cell, GoalType goal) const {
+        return distances_[static_cast<int>(goal)].distance[cell];
+    }
+
+    enum Direction {
+        kNorth,
+        kSouth,
+        kWest,
+        kEast,
+        kDirectionCount
     };
 
+    // 셀 번호 기준 한 칸 이동 (보드 경계와 벽 모두 반영)
+    bool canStep(int cell, Direction direction) const { return openEdges_[direction].test(cell); }
+    static int stepCell(int cell, Direction direction) {
+        static const int kOffsets[kDirectionCount] = {-kSize, kSize, -1, 1};
+        return cell + kOffsets[direction];
+    }
+
+    // 이미 놓인 벽과 겹치지 않는 슬롯들 (경로 검사 전)
+    void freeWallSlots(WallMask& horizontal, WallMask& vertical) const;
+    // 벽을 실제로 놓지 않고, 놓았을 때 starts[i]가 goals[i]에 여전히 닿는지 확인.
+    // 놓기 전에 이미 닿지 않는 starts[i]가 있으면 false다.
+    bool wallKeepsPaths(const Position& position, bool horizontal,
+                        const Position* starts, const GoalType* goals, int count) const;
+    // 지금 놓을 수 있는 벽 슬롯 전부 (겹치지 않고, 놓아도 모든 starts[i]가 goals[i]에 닿는다).
+    // 각 플레이어의 최단 경로 하나를 거리 맵에서 따라가 그 경로를 건드리지 않는 벽은 검사 없이 통과시키고,
+    // 건드리는 벽만 그 경로의 주인에 대해 flood fill로 확인한다. count는 kGoalCount 이하.
+    // 이미 목표에 닿지 않는 starts[i]가 있으면 (정상 진행에서는 생기지 않는다) 결과는 빈 집합이다.
+    void legalWallSlots(const Position* starts, const GoalType* goals, int count,
+                        WallMask& horizontal, WallMask& vertical) const;
+
+    // 방향별로 그 방향 이동이 열려 있는 셀 집합
+    const std::array<CellSet, kDirectionCount>& openEdges() const { return openEdges_; }
+    // openEdges에서 (position, horizontal) 벽이 막는 변 네 개를 닫는다
+    static void closeWallEdges(const Position& position, bool horizontal,
+                               std::array<CellSet, kDirectionCount>& openEdges);
+
+private:
+    static const CellSet kGoalMasks[kGoalCount];  // GoalType 순서
+
+    static WallMask wallBit(const Position& position) {
+        WallMask bit{};
+        maskSet(bit, position.row * kWallGrid + position.col);
+        return bit;
+    }
+
     bool overlapsExistingWall(const Position& position, bool horizontal) const;
+    void setWallEdges(const Position& position, bool horizontal, bool blocked);
+    CellSet expand(const CellSet& frontier) const { return expand(frontier, openEdges_); }
+    static CellSet expand(const CellSet& frontier,
+                          const std::array<CellSet, kDirectionCount>& openEdges);
+    static bool reaches(const CellSet& start, const CellSet& goal,
+                        const std::array<CellSet, kDirectionCount>& openEdges);
+    int wallContactCount(const Position& position, bool horizontal) const;
+    // cell에서 direction으로 가는 변을 막는 벽 슬롯들을 더한다
+    static void addBlockingSlots(int cell, Direction direction, WallMask& horizontal, WallMask& vertical);
+    // start에서 goal까지 최단 경로 하나를 막을 수 있는 벽 슬롯들
+    void pathWallSlots(const Position& start, GoalType goal, WallMask& horizontal, WallMask& vertical) const;
 
-    std::vector<WallPlacement> walls_;
+    // 목표 가장자리 하나에 대한 BFS 결과. levels[k]는 거리가 정확히 k인 셀 집합.
+    struct DistanceMap {
+        std::array<std::uint8_t, kCellCount> distance;
+        std::array<CellSet, kCellCount + 1> levels;
+        int levelCount;
+    };
+
+    void relabelComponents();
+    void recomputeDistances(int goal);
+    void repairDistances(int goal, const Position& position, bool horizontal, bool blocked);
+
+    WallMask horizontalWalls_;
+    WallMask verticalWalls_;
+    // 방향별로 그 방향 이동이 열려있는 셀 집합 (보드 가장자리와 벽 반영)
+    std::array<CellSet, kDirectionCount> openEdges_;
+    std::array<DistanceMap, kGoalCount> distances_;
+    std::array<std::uint8_t, kCellCount> components_;
+    int componentCount_;
 };
 
+using Board = BasicBoard<9>;
+
 #endif  // BOARD_HPP
@@ -0,0 +1,194 @@
+#include "BoardRenderer.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "GameState.h"
+
+namespace {
+constexpr const char* kResetColor = "\033[0m";
+
+// BoardRenderer::Color 순서
+const char* const kColorCodes[] = {
+    "", "\033[31m", "\033[32m", "\033[33m", "\033[34m"
+};
+
+// 좌석 순서대로 노랑, 초록, 빨강, 파랑
+const std::uint8_t kPlayerColors[] = {3, 2, 1, 4};
+
+// 한 칸의 최대 바이트: 색 5 + 기호 3 + 리셋 4
+constexpr std::size_t kMaxGlyphBytes = 12;
+
+constexpr const char* kClearScreen = "\033[H\033[2J";
+constexpr const char* kClearBelow = "\033[J";
+// 바뀐 칸 사이가 이 정도로 가까우면 커서를 옮기지 않고 사이 칸을 그냥 다시 쓴다
+constexpr int kMaxRewriteGap = 3;
+}  // namespace
+
+constexpr int BoardRenderer::kRows;
+constexpr int BoardRenderer::kCols;
+constexpr std::uint8_t BoardRenderer::kCellSymbol;
+constexpr std::uint8_t BoardRenderer::kWallSymbol;
+
+BoardRenderer::BoardRenderer()
+    : mode_(Mode::Full), hasPrevious_(false), framesWritten_(0), bytesWritten_(0) {
+    buffer_.reserve(kRows * (kCols * kMaxGlyphBytes + 1));
+}
+
+std::size_t BoardRenderer::draw(const Board& board, const Position* pawns, std::size_t pawnCount) {
+    compose(board, pawns, pawnCount);
+
+    if (mode_ == Mode::SkipUnchanged && hasPrevious_ &&
+        std::memcmp(screen_, previous_, sizeof(screen_)) == 0) {
+        return 0;
+    }
+
+    if (mode_ == Mode::Diff) {
+        encodeDiff();
+    } else {
+        encodeFull();
+    }
+    writeBuffer();
+    std::memcpy(previous_, screen_, sizeof(screen_));
+    hasPrevious_ = true;
+    return buffer_.size();
+}
+
+void BoardRenderer::compose(const Board& board, const Position* pawns, std::size_t pawnCount) {
+    const Glyph blank = {' ', kNoColor};
+    for (auto& row : screen_) {
+        for (Glyph& glyph : row) {
+            glyph = blank;
+        }
+    }
+
+    // 1) 맨 위 알파벳 줄 (A ~ H), 네모 사이 가운데
+    for (int g = 0; g < Board::kSize - 1; ++g) {
+        screen_[0][6 + 6 * g].symbol = static_cast<std::uint8_t>('A' + g);
+    }
+
+    // 2) 셀행 (1,3,5,...)과 그 아래 숫자행 (1~N-1)
+    for (int r = 0; r < Board::kSize; ++r) {
+        const int cellRow = 1 + 2 * r;
+        for (int c = 0; c < Board::kSize; ++c) {
+            Glyph& glyph = screen_[cellRow][3 + 6 * c];
+            glyph.symbol = kCellSymbol;
+            Position position;
+            position.row = r;
+            position.col = c;
+            glyph.color = GameState::isRedCellPosition(position) ? kRed : kNoColor;
+        }
+        if (r < Board::kSize - 1) {
+            screen_[cellRow + 1][1].symbol = static_cast<std::uint8_t>('1' + r);
+        }
+    }
+
+    // 3) 플레이어
+    for (std::size_t i = 0; i < pawnCount; ++i) {
+        const Position p = pawns[i];
+        if (!board.isWithinBounds(p)) continue;
+
+        Glyph& glyph = screen_[1 + 2 * p.row][3 + 6 * p.col];
+        glyph.symbol = static_cast<std::uint8_t>('1' + static_cast<int>(i));
+        glyph.color = i < sizeof(kPlayerColors) ? kPlayerColors[i] : static_cast<std::uint8_t>(kNoColor);
+    }
+
+    // 4) 벽: 숫자행/알파벳열 교차점이 중심, 가로면 양옆 셀 열, 세로면 위아래 셀 행까지
+    const Glyph wall = {kWallSymbol, kBlue};
+    for (int slot = 0; slot < Board::kWallSlotCount; ++slot) {
+        const Position position = Board::wallSlotPosition(slot);
+        const bool horizontal = Board::isHorizontalSlot(slot);
+        if (!board.hasWall(position, horizontal)) {
+            continue;
+        }
+
+        const int centerRow = 2 + 2 * position.row;
+        const int centerCol = 6 + 6 * position.col;
+        screen_[centerRow][centerCol] = wall;
+        if (horizontal) {
+            screen_[centerRow][centerCol - 3] = wall;
+            screen_[centerRow][centerCol + 3] = wall;
+        } else {
+            screen_[centerRow - 1][centerCol] = wall;
+            screen_[centerRow + 1][centerCol] = wall;
+        }
+    }
+}
+
+void BoardRenderer::encodeFull() {
+    buffer_.clear();
+    for (int r = 0; r < kRows; ++r) {
+        for (int c = 0; c < kCols; ++c) {
+            appendGlyph(screen_[r][c]);
+        }
+        buffer_ += '\n';
+    }
+}
+
+void BoardRenderer::encodeDiff() {
+    if (!hasPrevious_) {
+        encodeFull();
+        buffer_.insert(0, kClearScreen);
+    } else {
+        buffer_.clear();
+        appendChangedCells();
+    }
+
+    // 상태 문구는 보드 바로 아래에 다시 쓴다
+    appendCursor(kRows, 0);
+    buffer_ += kClearBelow;
+}
+
+void BoardRenderer::appendChangedCells() {
+    for (int r = 0; r < kRows; ++r) {
+        int cursor = -1;  // 이 행에서 커서가 있는 열 (모르면 -1)
+        for (int c = 0; c < kCols; ++c) {
+            if (screen_[r][c] == previous_[r][c]) {
+                continue;
+            }
+            if (cursor >= 0 && c - cursor <= kMaxRewriteGap) {
+                for (; cursor < c; ++cursor) {
+                    appendGlyph(screen_[r][cursor]);
+                }
+            } else {
+                appendCursor(r, c);
+            }
+            appendGlyph(screen_[r][c]);
+            cursor = c + 1;
+        }
+    }
+}
+
+void BoardRenderer::appendCursor(int row, int col) {
+    // 터미널 좌표는 1부터
+    buffer_ += "\033[";
+    buffer_ += std::to_string(row + 1);
+    buffer_ += ';';
+    buffer_ += std::to_string(col + 1);
+    buffer_ += 'H';
+}
+
+void BoardRenderer::appendGlyph(const Glyph& glyph) {
+    if (glyph.color != kNoColor) {
+        buffer_ += kColorCodes[glyph.color];
+    }
+    if (glyph.symbol == kCellSymbol) {
+        buffer_ += u8"□";
+    } else if (glyph.symbol == kWallSymbol) {
+        buffer_ += u8"■";
+    } else {
+        buffer_ += static_cast<char>(glyph.symbol);
+    }
+    if (glyph.color != kNoColor) {
+        buffer_ += kResetColor;
+    }
+}
+
+void BoardRenderer::writeBuffer() {
+    // 앞서 cout으로 쓴 글이 먼저 나가도록 비운 뒤 프레임을 한 번에 쓴다
+    std::fflush(stdout);
+    std::fwrite(buffer_.data(), 1, buffer_.size(), stdout);
+    std::fflush(stdout);
+    ++framesWritten_;
+    bytesWritten_ += buffer_.size();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef BOARDRENDERER_HPP
+#define BOARDRENDERER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+
+// 콘솔 보드 그리기. 화면을 글자 단위 격자(기호 + 색)로 먼저 채운 뒤
+// 재사용하는 버퍼 하나에 ANSI 바이트를 쓰고 write 한 번으로 내보낸다.
+//
+// Diff 모드는 관전용이다: 첫 프레임에서 화면을 지우고 보드를 맨 위에 그린 뒤, 다음부터는
+// 직전 프레임과 기호나 색이 달라진 칸만 커서 이동 escape와 함께 보낸다. 보드 아래는
+// 매번 지우고 커서를 그리로 옮겨 두므로 상태 문구는 보드 밑에 새로 찍힌다.
+class BoardRenderer {
+public:
+    enum class Mode {
+        Full,           // 매번 전체를 그린다 (기본, 예전 drawBoard와 같은 출력)
+        SkipUnchanged,  // 직전에 내보낸 화면과 같으면 아무것도 쓰지 않는다
+        Diff            // 보드를 화면 맨 위에 고정하고 바뀐 칸만 커서를 옮겨 다시 쓴다
+    };
+
+    // 0행 알파벳 + (셀행/숫자행) 반복, "  " + 셀 N개 + 셀 사이 5칸
+    static constexpr int kRows = 2 * Board::kSize;
+    static constexpr int kCols = 3 + Board::kSize + (Board::kSize - 1) * 5;
+
+    BoardRenderer();
+
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode mode() const { return mode_; }
+
+    // 화면을 그린다. pawns는 좌석 순서대로 폰 위치다.
+    // 실제로 내보낸 바이트 수를 돌려준다 (건너뛰면 0).
+    std::size_t draw(const Board& board, const Position* pawns, std::size_t pawnCount);
+
+    std::uint64_t framesWritten() const { return framesWritten_; }
+    std::uint64_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    enum Color : std::uint8_t {
+        kNoColor,
+        kRed,
+        kGreen,
+        kYellow,
+        kBlue
+    };
+
+    // 화면 한 칸. symbol은 ASCII 문자이거나 아래 두 기호 중 하나
+    struct Glyph {
+        std::uint8_t symbol;
+        std::uint8_t color;
+
+        bool operator==(const Glyph& other) const {
+            return symbol == other.symbol && color == other.color;
+        }
+    };
+
+    static constexpr std::uint8_t kCellSymbol = 0x80;  // □
+    static constexpr std::uint8_t kWallSymbol = 0x81;  // ■
+
+    void compose(const Board& board, const Position* pawns, std::size_t pawnCount);
+    void encodeFull();
+    void encodeDiff();
+    void appendChangedCells();
+    void appendCursor(int row, int col);
+    void appendGlyph(const Glyph& glyph);
+    void writeBuffer();
+
+    Mode mode_;
+    Glyph screen_[kRows][kCols];
+    Glyph previous_[kRows][kCols];
+    bool hasPrevious_;
+    std::string buffer_;
+    std::uint64_t framesWritten_;
+    std::uint64_t bytesWritten_;
+};
+
+#endif  // BOARDRENDERER_HPP
@@ -0,0 +1,134 @@
+#pragma once
+#ifndef CELLSET_HPP
+#define CELLSET_HPP
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 보드 셀 집합 (최대 128칸). 셀 번호는 row * kSize + col.
+// 이웃 이동은 시프트 한 번으로 표현되므로 BFS 프런티어를 한꺼번에 확장할 수 있다.
+struct CellSet {
+    std::uint64_t lo = 0;  // cells 0..63
+    std::uint64_t hi = 0;  // cells 64..127
+
+    constexpr CellSet() = default;
+    constexpr CellSet(std::uint64_t low, std::uint64_t high) : lo(low), hi(high) {}
+
+    static constexpr CellSet single(int index) {
+        return index < 64 ? CellSet(std::uint64_t{1} << index, 0)
+                          : CellSet(0, std::uint64_t{1} << (index - 64));
+    }
+
+    // 0..count-1 번 셀이 모두 들어있는 집합
+    static constexpr CellSet firstN(int count) {
+        return count >= 128 ? CellSet(~std::uint64_t{0}, ~std::uint64_t{0})
+             : count > 64   ? CellSet(~std::uint64_t{0}, (std::uint64_t{1} << (count - 64)) - 1)
+             : count == 64  ? CellSet(~std::uint64_t{0}, 0)
+                            : CellSet((std::uint64_t{1} << count) - 1, 0);
+    }
+
+    constexpr bool test(int index) const {
+        return index < 64 ? ((lo >> index) & 1) != 0 : ((hi >> (index - 64)) & 1) != 0;
+    }
+    constexpr void set(int index) {
+        if (index < 64) lo |= std::uint64_t{1} << index;
+        else hi |= std::uint64_t{1} << (index - 64);
+    }
+    constexpr void reset(int index) {
+        if (index < 64) lo &= ~(std::uint64_t{1} << index);
+        else hi &= ~(std::uint64_t{1} << (index - 64));
+    }
+
+    constexpr bool any() const { return (lo | hi) != 0; }
+    constexpr bool none() const { return (lo | hi) == 0; }
+    constexpr bool intersects(const CellSet& other) const {
+        return ((lo & other.lo) | (hi & other.hi)) != 0;
+    }
+
+    // 셀 번호가 커지는 방향 (<<), 0 < n < 64
+    constexpr CellSet shiftUp(int n) const {
+        return CellSet(lo << n, (hi << n) | (lo >> (64 - n)));
+    }
+    // 셀 번호가 작아지는 방향 (>>), 0 < n < 64
+    constexpr CellSet shiftDown(int n) const {
+        return CellSet((lo >> n) | (hi << (64 - n)), hi >> n);
+    }
+
+    int count() const { return popcount(lo) + popcount(hi); }
+
+    // 가장 작은 셀 번호 (비어있으면 -1)
+    int lowest() const {
+        if (lo) return countTrailingZeros(lo);
+        if (hi) return 64 + countTrailingZeros(hi);
+        return -1;
+    }
+    int popLowest() {
+        const int index = lowest();
+        if (lo) lo &= lo - 1;
+        else hi &= hi - 1;
+        return index;
+    }
+
+    static int popcount(std::uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<int>(__popcnt64(value));
+#elif defined(_MSC_VER)
+        return static_cast<int>(__popcnt(static_cast<unsigned>(value)) +
+                                __popcnt(static_cast<unsigned>(value >> 32)));
+#else
+        return __builtin_popcountll(value);
+#endif
+    }
+
+    static int countTrailingZeros(std::uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<unsigned long>(value))) {
+            return static_cast<int>(index);
+        }
+        _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+        return static_cast<int>(index) + 32;
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+};
+
+constexpr CellSet operator|(const CellSet& a, const CellSet& b) { return CellSet(a.lo | b.lo, a.hi | b.hi); }
+constexpr CellSet operator&(const CellSet& a, const CellSet& b) { return CellSet(a.lo & b.lo, a.hi & b.hi); }
+constexpr CellSet operator^(const CellSet& a, const CellSet& b) { return CellSet(a.lo ^ b.lo, a.hi ^ b.hi); }
+constexpr CellSet operator~(const CellSet& a) { return CellSet(~a.lo, ~a.hi); }
+constexpr bool operator==(const CellSet& a, const CellSet& b) { return a.lo == b.lo && a.hi == b.hi; }
+constexpr bool operator!=(const CellSet& a, const CellSet& b) { return !(a == b); }
+
+inline CellSet& operator|=(CellSet& a, const CellSet& b) { a = a | b; return a; }
+inline CellSet& operator&=(CellSet& a, const CellSet& b) { a = a & b; return a; }
+inline CellSet& operator^=(CellSet& a, const CellSet& b) { a = a ^ b; return a; }
+
+// 0 < n < 64
+constexpr CellSet operator<<(const CellSet& a, int n) { return a.shiftUp(n); }
+constexpr CellSet operator>>(const CellSet& a, int n) { return a.shiftDown(n); }
+
+// 벽 슬롯 마스크는 슬롯이 64개 이하면 std::uint64_t, 넘으면 CellSet이다.
+// 둘을 같은 코드로 다루기 위한 도우미.
+constexpr bool maskEmpty(std::uint64_t mask) { return mask == 0; }
+constexpr bool maskEmpty(const CellSet& mask) { return mask.none(); }
+constexpr bool maskTest(std::uint64_t mask, int index) { return ((mask >> index) & 1) != 0; }
+constexpr bool maskTest(const CellSet& mask, int index) { return mask.test(index); }
+constexpr void maskSet(std::uint64_t& mask, int index) { mask |= std::uint64_t{1} << index; }
+constexpr void maskSet(CellSet& mask, int index) { mask.set(index); }
+inline int maskPopLowest(std::uint64_t& mask) {
+    const int index = CellSet::countTrailingZeros(mask);
+    mask &= mask - 1;
+    return index;
+}
+inline int maskPopLowest(CellSet& mask) { return mask.popLowest(); }
+
+#endif  // CELLSET_HPP
@@ -0,0 +1,353 @@
+#include "Endgame.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+// 판정은 풀이를 시작한 좌석 기준이라 표 키에 그 좌석을 섞는다 (Search.cpp와 같은 상수)
+const std::uint64_t kRootSeatKeys[GameState::kPlayerCount] = {
+    0x0000000000000000ULL, 0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL
+};
+
+// 폰 수가 끝났을 때 그 좌석 폰이 있을 셀
+int landingCell(const GameState& state, const Move& move) {
+    return move.isSwap() ? state.pawnCell(move.swapWith) : move.to;
+}
+
+// 새 제한이 앞서 떨어진 제한보다 크지 않은가 (0은 제한 없음이라 어떤 값보다 크다)
+template <typename T>
+bool notLarger(T limit, T spent) {
+    return spent == 0 || (limit != 0 && limit <= spent);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+constexpr int EndgameSolver::kDefaultMaxMoves;
+constexpr std::uint64_t EndgameSolver::kDefaultNodeLimit;
+constexpr std::int8_t EndgameSolver::kUnknown;
+constexpr std::size_t EndgameSolver::kAttemptCount;
+
+EndgameSolver::EndgameSolver(std::size_t megabytes)
+    : capacity_(std::max<std::size_t>(1, megabytes * 1024 * 1024 / sizeof(Entry))),
+      rootSeat_(0), nodes_(0), nodeLimit_(0), hasDeadline_(false), aborted_(false) {
+}
+
+EndgameSolver::Budget EndgameSolver::Budget::forMove(int timeMillis, std::uint64_t maxNodes) {
+    Budget budget;
+    if (timeMillis > 0 || maxNodes > 0) {
+        budget.timeMillis = timeMillis > 0 ? std::max(1, timeMillis / 2) : 0;
+        budget.nodes = maxNodes > 0 ? std::max<std::uint64_t>(1, maxNodes / 2) : 0;
+    }
+    return budget;
+}
+
+bool EndgameSolver::applies(const GameState& state) {
+    if (state.isGameOver()) {
+        return false;
+    }
+    for (std::size_t seat = 0; seat < state.playerCount(); ++seat) {
+        if (state.hasWallsRemaining(seat)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EndgameSolver::solve(const GameState& state, Result& result) {
+    return solve(state, result, Budget());
+}
+
+bool EndgameSolver::solve(const GameState& state, Result& result, const Budget& budget) {
+    const auto start = std::chrono::steady_clock::now();
+    result = Result();
+    if (!applies(state)) {
+        return false;
+    }
+    if (!table_) {
+        table_.reset(new Entry[capacity_]);
+        std::fill(table_.get(), table_.get() + capacity_, Entry{0, kUnknown, kUnknown});
+        attempts_.reset(new Attempt[kAttemptCount]);
+        std::fill(attempts_.get(), attempts_.get() + kAttemptCount, Attempt{0, 0, Budget()});
+    }
+
+    // 자기 수는 int8로 기억한다
+    const int maxMoves = std::min(budget.maxMoves, 100);
+    state_ = state;
+    rootSeat_ = state.currentTurn();
+
+    // 못 이긴다고 증명했거나, 이보다 크지 않은 예산으로 이미 그만뒀던 국면이면 다시 풀지 않는다
+    const std::uint64_t rootKey = key();
+    const Entry& known = entryFor(rootKey);
+    Attempt& attempt = attempts_[rootKey % kAttemptCount];
+    if ((known.key == rootKey && known.failWithin >= maxMoves) ||
+        (attempt.key == rootKey && maxMoves <= attempt.maxMoves &&
+         notLarger(budget.nodes, attempt.budget.nodes) &&
+         notLarger(budget.timeMillis, attempt.budget.timeMillis))) {
+        result.seconds = secondsSince(start);
+        return false;
+    }
+
+    nodes_ = 0;
+    nodeLimit_ = budget.nodes > 0 ? budget.nodes : ~std::uint64_t(0);
+    hasDeadline_ = budget.timeMillis > 0;
+    deadline_ = start + std::chrono::milliseconds(budget.timeMillis);
+    aborted_ = false;
+    computeLowerBounds();
+
+    GameState::MoveList rootMoves;
+    state_.legalPawnMoves(rootMoves);
+    orderMoves(rootMoves);
+
+    bool found = false;
+    const int firstDepth = std::max<int>(1, lowerBound_[state_.pawnCell(rootSeat_)]);
+    for (int moves = firstDepth; moves <= maxMoves && !found && !aborted_; ++moves) {
+        for (const Move& move : rootMoves) {
+            state_.makeMove(move);
+            const bool wins = forcesWin(moves - 1);
+            state_.unmakeMove(move);
+            if (aborted_) {
+                break;
+            }
+            if (wins) {
+                result.move = move;
+                result.moves = moves;
+                result.plies = (moves - 1) * GameState::kPlayerCount + 1;
+                found = true;
+                break;
+            }
+        }
+    }
+
+    if (aborted_) {
+        attempt = Attempt{rootKey, maxMoves, budget};
+    } else if (!found) {
+        Entry& entry = entryFor(rootKey);
+        if (entry.key != rootKey) {
+            entry = Entry{rootKey, kUnknown, kUnknown};
+        }
+        entry.failWithin = std::max(entry.failWithin, static_cast<std::int8_t>(maxMoves));
+    }
+
+    result.nodes = nodes_;
+    result.seconds = secondsSince(start);
+    return found;
+}
+
+// 루트 좌석이 지금부터 자기 수 movesLeft번 안에 (상대가 무엇을 두든) 도착하는가
+bool EndgameSolver::forcesWin(int movesLeft) {
+    // 시계는 노드 1024개마다 본다
+    if (++nodes_ > nodeLimit_ ||
+        (hasDeadline_ && (nodes_ & 1023) == 0 && std::chrono::steady_clock::now() >= deadline_)) {
+        aborted_ = true;
+        return false;
+    }
+    if (state_.isGameOver()) {
+        return static_cast<std::size_t>(state_.winner()) == rootSeat_;
+    }
+    // 상대의 자리바꾸기는 루트 폰을 목표가 아닌 빨간 칸으로 옮길 뿐이라, 루트는 자기 수로만 도착한다
+    if (movesLeft <= 0 || lowerBound_[state_.pawnCell(rootSeat_)] > movesLeft) {
+        return false;
+    }
+
+    const std::uint64_t tableKey = key();
+    {
+        const Entry& entry = entryFor(tableKey);
+        if (entry.key == tableKey) {
+            if (entry.winWithin != kUnknown && entry.winWithin <= movesLeft) {
+                return true;
+            }
+            if (entry.failWithin >= movesLeft) {
+                return false;
+            }
+        }
+    }
+
+    GameState::MoveList moves;
+    state_.legalPawnMoves(moves);
+    orderMoves(moves);
+
+    // 루트 차례면 이기는 수 하나로 충분하고, 상대 차례면 모든 응수에 이겨야 한다
+    const bool rootToMove = state_.currentTurn() == rootSeat_;
+    const int childMoves = rootToMove ? movesLeft - 1 : movesLeft;
+    bool wins = !rootToMove && !moves.empty();
+    for (const Move& move : moves) {
+        state_.makeMove(move);
+        const bool childWins = forcesWin(childMoves);
+        state_.unmakeMove(move);
+        if (aborted_) {
+            return false;
+        }
+        if (childWins == rootToMove) {
+            wins = rootToMove;
+            break;
+        }
+    }
+
+    Entry& entry = entryFor(tableKey);
+    if (entry.key != tableKey) {
+        entry = Entry{tableKey, kUnknown, kUnknown};
+    }
+    const std::int8_t depth = static_cast<std::int8_t>(movesLeft);
+    if (wins) {
+        entry.winWithin = entry.winWithin == kUnknown ? depth : std::min(entry.winWithin, depth);
+    } else {
+        entry.failWithin = std::max(entry.failWithin, depth);
+    }
+    return wins;
+}
+
+// 둘 좌석의 목표에 가까워지는 수부터. 루트는 빨리 이기는 수를, 상대는 자기가 먼저 도착하는 반박을 먼저 찾는다.
+void EndgameSolver::orderMoves(GameState::MoveList& moves) const {
+    const std::size_t seat = state_.currentTurn();
+    const GoalType goal = state_.goalOf(seat);
+    int scores[GameState::MoveList::kCapacity];
+    for (int i = 0; i < moves.size(); ++i) {
+        scores[i] = state_.board().distanceToGoal(landingCell(state_, moves[i]), goal);
+    }
+
+    for (int i = 1; i < moves.size(); ++i) {
+        const Move move = moves[i];
+        const int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] > score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            --j;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+EndgameSolver::Entry& EndgameSolver::entryFor(std::uint64_t tableKey) {
+    return table_[tableKey % capacity_];
+}
+
+std::uint64_t EndgameSolver::key() const {
+    return state_.hash() ^ kRootSeatKeys[rootSeat_];
+}
+
+// 한 수에 폰은 벽 기준 거리로 많아야 2칸 간다 (점프, 또는 상대를 끼고 도는 대각선).
+// 그보다 멀리 가는 길은 빨간 칸에 들어가 다른 폰과 자리를 바꾸는 것뿐이고, 바꾼 자리가 곧 목표일 수도 있다.
+void EndgameSolver::computeLowerBounds() {
+    const Board& board = state_.board();
+    int redDistance[Board::kCellCount];
+    std::fill(std::begin(redDistance), std::end(redDistance), Board::kUnreachable);
+    int queue[Board::kCellCount];
+    int head = 0;
+    int tail = 0;
+    for (int i = 0; i < GameState::kRedCellCount; ++i) {
+        const int cell = Board::cellIndex(GameState::redCellPosition(i));
+        if (redDistance[cell] != 0) {
+            redDistance[cell] = 0;
+            queue[tail++] = cell;
+        }
+    }
+    while (head < tail) {
+        const int cell = queue[head++];
+        for (int direction = 0; direction < Board::kDirectionCount; ++direction) {
+            const Board::Direction step = static_cast<Board::Direction>(direction);
+            if (!board.canStep(cell, step)) {
+                continue;
+            }
+            const int next = Board::stepCell(cell, step);
+            if (redDistance[next] == Board::kUnreachable) {
+                redDistance[next] = redDistance[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    const GoalType goal = state_.goalOf(rootSeat_);
+    for (int cell = 0; cell < Board::kCellCount; ++cell) {
+        const int goalMoves = (board.distanceToGoal(cell, goal) + 1) / 2;
+        // 빨간 칸 위에 있어도 다시 빨간 칸에 들어가야 바꿀 수 있으므로 한 수는 든다
+        const int swapMoves = std::max(1, (redDistance[cell] + 1) / 2);
+        lowerBound_[cell] = static_cast<std::uint8_t>(std::min(goalMoves, swapMoves));
+    }
+}
+
+int runEndgameBenchCommand(int argc, char** argv) {
+    int positions = 200;
+    if (argc > 0) positions = std::atoi(argv[0]);
+    if (positions <= 0) {
+        std::cout << "usage: project2 endgame-bench [positions]\n";
+        return 1;
+    }
+
+    // 벽을 다 쓸 때까지 아무 수나 두고 (대부분 벽이다), 폰만 몇 수 더 움직인 국면들
+    std::mt19937_64 random(0xE4D6);
+    std::vector<GameState> states;
+    GameState::MoveList moves;
+    while (static_cast<int>(states.size()) < positions) {
+        GameState state;
+        while (!state.isGameOver() && !EndgameSolver::applies(state)) {
+            state.legalMoves(moves);
+            if (moves.size() == 0) break;
+            state.makeMove(moves[static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()))]);
+        }
+        const int plies = static_cast<int>(random() % 48);
+        for (int ply = 0; ply < plies && EndgameSolver::applies(state); ++ply) {
+            state.legalPawnMoves(moves);
+            if (moves.size() == 0) break;
+            state.makeMove(moves[static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()))]);
+        }
+        if (EndgameSolver::applies(state)) {
+            states.push_back(state);
+        }
+    }
+
+    EndgameSolver solver;
+    int solved = 0;
+    int broken = 0;
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    double slowest = 0;
+    for (const GameState& position : states) {
+        EndgameSolver::Result result;
+        const bool found = solver.solve(position, result);
+        nodes += result.nodes;
+        seconds += result.seconds;
+        slowest = std::max(slowest, result.seconds);
+        if (!found) {
+            continue;
+        }
+        ++solved;
+
+        // 약속한 수 안에 도착하는지: 루트는 풀이기의 수를, 상대는 무작위 폰 수를 둔다
+        GameState game = position;
+        const std::size_t seat = position.currentTurn();
+        int movesLeft = result.moves;
+        while (!game.isGameOver() && movesLeft > 0) {
+            if (game.currentTurn() == seat) {
+                EndgameSolver::Result next;
+                if (!solver.solve(game, next) || next.moves > movesLeft) {
+                    break;
+                }
+                game.makeMove(next.move);
+                --movesLeft;
+            } else {
+                game.legalPawnMoves(moves);
+                if (moves.size() == 0) break;
+                game.makeMove(moves[static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()))]);
+            }
+        }
+        if (static_cast<std::size_t>(game.winner()) != seat) {
+            ++broken;
+        }
+    }
+
+    std::cout << "positions " << states.size() << ", forced wins " << solved
+              << ", failed replays " << broken << '\n'
+              << "nodes " << nodes << ", " << seconds << " s, "
+              << static_cast<std::uint64_t>(nodes / (seconds > 0 ? seconds : 1)) << " nodes/s, slowest "
+              << slowest << " s\n";
+    return broken == 0 ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Board.h"
+#include "GameState.h"
+#include "Move.h"
+
+// 네 좌석의 남은 벽이 모두 0인 국면 전용 풀이기.
+//
+// 벽이 더 바뀌지 않으므로 국면은 폰 네 개와 차례뿐인 달리기다 (점프, 대각선, 자리바꾸기 포함).
+// 탐색과 같은 paranoid 모델로, 차례인 좌석이 나머지 셋의 어떤 응수에도 자기 수 maxMoves번 안에
+// 도착을 강제할 수 있는지를 반복 심화 AND/OR 탐색으로 정확히 판정하고 가장 짧은 승리의 첫 수를 낸다.
+// 판정은 (국면, 남은 자기 수)의 상하한으로 표에 기억해 둔다. 벽이 고정이라 표는 게임 내내 유효하다.
+//
+// 가지치기는 건전한 하한 하나뿐이다: 한 수에 벽 기준 거리는 최대 2 줄고 (점프), 그보다 빠른 길은
+// 스스로 빨간 칸에 들어가 자리를 바꾸는 것뿐이다. 상대가 자리바꾸기로 옮겨 주는 경우는 상대가
+// 늘 바꾸지 않는 같은 수를 고를 수 있으므로 강제 승리 판정에는 영향이 없다.
+class EndgameSolver {
+public:
+    static constexpr int kDefaultMaxMoves = 16;
+    static constexpr std::uint64_t kDefaultNodeLimit = 2000000;
+
+    // 한 번의 풀이에 쓸 수 있는 만큼. 0인 제한은 없는 것이다.
+    struct Budget {
+        int maxMoves = kDefaultMaxMoves;
+        std::uint64_t nodes = kDefaultNodeLimit;
+        int timeMillis = 0;
+
+        // 탐색 한 수의 제한 중 풀이기 몫: 시간과 노드의 절반. 둘 다 없으면 (깊이로만 끊는 탐색) 기본 노드 수.
+        static Budget forMove(int timeMillis, std::uint64_t maxNodes);
+    };
+
+    struct Result {
+        Move move;              // 가장 짧은 강제 승리의 첫 수
+        int moves = 0;          // 그 승리까지 자기 수 (move 포함)
+        int plies = 0;          // 도착까지 전체 수 (상대 수 포함)
+        std::uint64_t nodes = 0;
+        double seconds = 0;
+    };
+
+    // 표 크기. 첫 풀이 때 한 번 잡는다.
+    explicit EndgameSolver(std::size_t megabytes = 4);
+
+    // 네 좌석 모두 벽이 없고 게임이 끝나지 않았는지
+    static bool applies(const GameState& state);
+
+    // 차례인 좌석의 강제 승리를 찾으면 true. 없거나 (maxMoves 안에) 예산 안에 판정하지 못하면 false.
+    // 못 이긴다고 증명한 국면은 표에 남겨서, 같은 국면을 같거나 짧은 maxMoves로 다시 부르면 바로 false를 낸다.
+    // 예산이 떨어져 그만둔 국면은 그때의 maxMoves와 예산을 기억해 두고, 그보다 maxMoves도 예산(노드, 시간)도
+    // 크지 않은 호출만 바로 false를 낸다. 하나라도 크면 다시 푼다.
+    bool solve(const GameState& state, Result& result, const Budget& budget);
+    // 기본 예산 (자기 수 kDefaultMaxMoves, 노드 kDefaultNodeLimit)
+    bool solve(const GameState& state, Result& result);
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::int8_t winWithin;   // 이 자기 수 안에 이긴다고 증명됨 (kUnknown이면 없음)
+        std::int8_t failWithin;  // 이 자기 수로는 못 이긴다고 증명됨 (kUnknown이면 없음)
+    };
+    // 루트로 풀다가 예산이 떨어진 시도. 루트는 수마다 하나뿐이라 작은 표로 충분하다.
+    struct Attempt {
+        std::uint64_t key;
+        int maxMoves;
+        Budget budget;   // 떨어진 예산 (0인 제한은 없는 것)
+    };
+    static constexpr std::size_t kAttemptCount = 1024;
+    static constexpr std::int8_t kUnknown = -1;
+
+    bool forcesWin(int movesLeft);
+    void orderMoves(GameState::MoveList& moves) const;
+    Entry& entryFor(std::uint64_t key);
+    std::uint64_t key() const;
+    void computeLowerBounds();
+
+    std::unique_ptr<Entry[]> table_;
+    std::unique_ptr<Attempt[]> attempts_;
+    std::size_t capacity_;
+
+    // 풀이 하나 동안의 상태
+    GameState state_;
+    std::size_t rootSeat_;
+    std::uint64_t nodes_;
+    std::uint64_t nodeLimit_;
+    std::chrono::steady_clock::time_point deadline_;
+    bool hasDeadline_;
+    bool aborted_;
+    // 루트 좌석이 각 셀에서 도착하려면 적어도 몇 수가 드는지
+    std::uint8_t lowerBound_[Board::kCellCount];
+};
+
+// "project2 endgame-bench [positions]" 명령. 벽을 다 쓴 무작위 국면을 풀고, 찾은 강제 승리를
+// 무작위 상대들을 상대로 끝까지 둬서 약속한 수 안에 도착하는지 확인한다.
+int runEndgameBenchCommand(int argc, char** argv);
+
+#endif  // ENDGAME_HPP
@@ -1,10 +1,11 @@
 #include "Game.h"
 
 #include <cctype>
-#include <cstdlib>
 #include <iostream>
 #include <limits>
 
+#include "Notation.h"
+
 using namespace std;
 
 namespace {
@@ -14,6 +15,7 @@ inline Position makePos(int r, int c){
     p.col=c;
     return p;
 }
+
 bool isValidDirectionInput(char direction) {
     direction = static_cast<char>(std::tolower(static_cast<unsigned char>(direction)));
     switch (direction) {
@@ -47,10 +49,38 @@ const char* colorForPlayerIndex(std::size_t index) {
     }
 }
 
+// 좌석 번호로 만드는 표시용 이름 ("Player 1" ~ "Player 4")
+std::string seatName(std::size_t index) {
+    return "Player " + std::to_string(index + 1);
+}
+
 std::string colorizeText(const std::string& text, const char* color) {
     return std::string(color) + text + kResetColor;
 }
 
+const char* messageFor(MoveError error) {
+    switch (error) {
+        case MoveError::GameOver: return "The game is already over.";
+        case MoveError::OutOfBounds: return "Move is outside the board.";
+        case MoveError::Blocked: return "A wall blocks that move.";
+        case MoveError::JumpOutOfBounds: return "Cannot jump outside the board.";
+        case MoveError::JumpBlocked: return "Cannot jump because a wall blocks the landing path.";
+        case MoveError::JumpOccupied: return "Cannot jump because the landing cell is occupied.";
+        case MoveError::TargetOccupied: return "Target cell is already occupied.";
+        case MoveError::DiagonalNotAllowed:
+            return "Diagonal move requires an adjacent opponent with a blocking wall and a clear diagonal path.";
+        case MoveError::IllegalPawnMove: return "That move is not allowed.";
+        case MoveError::InvalidSwapTarget: return "Invalid player ID. Try again.";
+        case MoveError::SwapPathBlocked: return "All paths are blocked by walls. Choose another player.";
+        case MoveError::NoWallsLeft: return "No walls remaining to place.";
+        case MoveError::WallOutOfRange: return "Wall position out of range.";
+        case MoveError::WallOverlaps: return "Cannot place a wall at that location.";
+        case MoveError::WallBlocksPath:
+            return "That wall blocks every route to a goal for at least one player.";
+        default: return "";
+    }
+}
+
 std::string colorizeDigits(const std::string& text, std::size_t playerIndex) {
     std::string result;
     const char* color = colorForPlayerIndex(playerIndex);
@@ -65,7 +95,23 @@ std::string colorizeDigits(const std::string& text, std::size_t playerIndex) {
 }
 }  // namespace
 
-Game::Game() : currentTurn_(0), isGameOver_(false), skipInputFlush_(false) {
+Game::Game(const GameOptions& options)
+    : options_(options), search_(options.hashMegabytes),
+      isGameOver_(false), skipInputFlush_(false) {
+    renderer_.setMode(options.render);
+    if (!options.recordPath.empty() && !recorder_.open(options.recordPath)) {
+        cout << "Cannot open record file " << options.recordPath << ".\n";
+    }
+    if (!options.bookPath.empty() && !book_.open(options.bookPath)) {
+        cout << "Cannot open opening book " << options.bookPath << ".\n";
+    }
+    if (!options.evalPath.empty()) {
+        if (network_.load(options.evalPath)) {
+            search_.setNetwork(&network_);
+        } else {
+            cout << "Cannot open network file " << options.evalPath << ".\n";
+        }
+    }
     initializePlayers();
 }
 
@@ -73,25 +119,35 @@ void Game::start() {
     initializePlayers();
     isGameOver_ = false;
     winnerName_.clear();
-    currentTurn_ = 0;
     skipInputFlush_ = false;
 
     cout << "Quoridor game start!\n";
 
+    record::SeatKinds seats;
+    for (std::size_t i = 0; i < seats.size(); ++i) {
+        switch (options_.seats[i]) {
+            case SeatType::Human: seats[i] = record::kHuman; break;
+            case SeatType::Computer: seats[i] = record::kAlphaBeta; break;
+            case SeatType::MonteCarlo: seats[i] = record::kMonteCarlo; break;
+        }
+    }
+    recorder_.beginGame(seats);
+
     while (!isGameOver_) {
         showStatus();
-        bool turnCompleted = handleInput();
+        bool turnCompleted = options_.seats[state_.currentTurn()] == SeatType::Human
+                                 ? handleInput()
+                                 : playComputerTurn();
         if (isGameOver_) {
             break;
         }
         if (turnCompleted) {
             checkGameOver();
-            if (!isGameOver_) {
-                nextTurn();
-            }
         }
     }
 
+    recorder_.endGame(state_.winner());
+
     if (!winnerName_.empty()) {
         cout << "Player" << winnerName_ << " wins!\n";
     } else {
@@ -102,41 +158,27 @@ void Game::start() {
 // Initialize players at their starting positions
 
 void Game::initializePlayers() {
-    board_.reset();
-    players_.clear();
-    playerGoals_.clear();
-
-    const int middle = Board::kSize / 2;
-    Position p1=makePos(middle, 0);
-    players_.emplace_back("Player 1", p1);
-    playerGoals_.push_back(determineGoalType(p1));
-
-    Position p2=makePos(middle, Board::kSize - 1);
-    players_.emplace_back("Player 2", p2);
-    playerGoals_.push_back(determineGoalType(p2));
-
-    Position p3=makePos(0, middle);
-    players_.emplace_back("Player 3", p3);
-    playerGoals_.push_back(determineGoalType(p3));
-
-    Position p4=makePos(Board::kSize - 1, middle);
-    players_.emplace_back("Player 4", p4);
-    playerGoals_.push_back(determineGoalType(p4));
+    state_.initializePlayers();
+}
+
+Player Game::displayPlayer(std::size_t index) const {
+    return Player(seatName(index), state_.pawnPosition(index), state_.wallsRemaining(index));
 }
 
 // Display the current status of the game
 
-void Game::showStatus() const {
-    board_.drawBoard(players_);
-    std::string coloredName = colorizeDigits(players_[currentTurn_].getName(),
-                                             currentTurn_);
+void Game::showStatus() {
+    const std::size_t currentTurn = state_.currentTurn();
+    const std::array<Position, GameState::kPlayerCount> pawns = state_.pawnPositions();
+    renderer_.draw(state_.board(), pawns.data(), pawns.size());
+    std::string coloredName = colorizeDigits(seatName(currentTurn), currentTurn);
     cout << coloredName << "'s turn. You have "
-         << players_[currentTurn_].getWallsRemaining()
+         << state_.wallsRemaining(currentTurn)
          << " walls left.\n";
     
     //지워야할!
-    for (const auto& player : players_) {
-        player.showStatus();
+    for (std::size_t i = 0; i < state_.playerCount(); ++i) {
+        displayPlayer(i).showStatus();
     }
 }
 
@@ -192,133 +234,107 @@ bool Game::handleInput() {
     return turnCompleted;
 }
 
-bool Game::handleMoveCommand(char direction) {
-    direction = static_cast<char>(std::tolower(static_cast<unsigned char>(direction)));
-    if (!isValidDirectionInput(direction)) {
-        cout << "Invalid direction. Use the keys surrounding 'j' (h, y, u, i, k, n, m, b).\n";
-        return false;
+// 컴퓨터 좌석: 탐색으로 고른 수를 바로 둔다
+
+bool Game::playComputerTurn() {
+    const std::size_t currentTurn = state_.currentTurn();
+    const std::string name = seatName(currentTurn);
+
+    // 책에 있는 국면이면 탐색하지 않는다
+    Move bookMove;
+    const OpeningBook::Entry* entry = nullptr;
+    if (book_.probe(state_, bookMove, &entry)) {
+        cout << name << " plays " << notation::moveName(bookMove) << " (book, " << entry->games
+             << " games, " << entry->wins << " wins)\n";
+        MoveError error = playMove(bookMove);
+        if (error != MoveError::None) {
+            cout << messageFor(error) << '\n';
+            return false;
+        }
+        return true;
     }
 
-    Position current = players_[currentTurn_].getPosition();
-    Position target = players_[currentTurn_].previewMove(direction);
-
-    if (!board_.isWithinBounds(target)) {
-        cout << "Move is outside the board.\n";
+    const bool monteCarlo = options_.seats[currentTurn] == SeatType::MonteCarlo;
+    SearchResult result = monteCarlo ? mcts_.search(state_, options_.search)
+                                     : search_.search(state_, options_.search);
+    if (!result.hasMove) {
+        cout << name << " has no legal move.\n";
+        isGameOver_ = true;
         return false;
     }
 
-    bool isDiagonal = (current.row != target.row) && (current.col != target.col);
-    if (isDiagonal) {
-        return handleDiagonalMove(direction, current, target);
-    }
-
-    return handleOrthogonalMove(direction, current, target);
-}
-
-bool Game::handleOrthogonalMove(char direction,
-                                const Position& current,
-                                const Position& target) {
-    if (board_.isMoveBlocked(current, target)) {
-        cout << "A wall blocks that move.\n";
+    const char* unit = monteCarlo ? "playouts" : "nodes";
+    cout << name << " plays " << notation::moveName(result.bestMove)
+         << " (depth " << result.depth << ", " << result.nodes << ' ' << unit << ", "
+         << static_cast<std::uint64_t>(result.nodes / (result.seconds > 0 ? result.seconds : 1))
+         << ' ' << unit << "/s)\n";
+    MoveError error = playMove(result.bestMove);
+    if (error != MoveError::None) {
+        cout << messageFor(error) << '\n';
         return false;
     }
+    return true;
+}
 
-    if (isCellOccupied(target, currentTurn_)) {
-        Position jumpTarget=makePos(
-            target.row + (target.row - current.row),
-            target.col + (target.col - current.col)
-        );
-
-        if (!board_.isWithinBounds(jumpTarget)) {
-            cout << "Cannot jump outside the board.\n";
-            return false;
-        }
-
-        if (board_.isMoveBlocked(target, jumpTarget)) {
-            cout << "Cannot jump because a wall blocks the landing path.\n";
-            return false;
-        }
-
-        if (isCellOccupied(jumpTarget, currentTurn_)) {
-            cout << "Cannot jump because the landing cell is occupied.\n";
-            return false;
-        }
-
-        players_[currentTurn_].move(direction, 2);
-        handleRedCellInteraction();
-        return true;
+// 모든 수가 여기를 지난다. 둔 수는 바로 기보에 남긴다.
+MoveError Game::playMove(const Move& move) {
+    const MoveError error = state_.apply(move);
+    if (error == MoveError::None) {
+        recorder_.appendMove(move);
     }
-
-    players_[currentTurn_].move(direction);
-    handleRedCellInteraction();
-    return true;
+    return error;
 }
 
-bool Game::handleDiagonalMove(char direction,
-                              const Position& current,
-                              const Position& target) {
-    if (isCellOccupied(target, currentTurn_)) {
-        cout << "Target cell is already occupied.\n";
+bool Game::handleMoveCommand(char direction) {
+    direction = static_cast<char>(std::tolower(static_cast<unsigned char>(direction)));
+    if (!isValidDirectionInput(direction)) {
+        cout << "Invalid direction. Use the keys surrounding 'j' (h, y, u, i, k, n, m, b).\n";
         return false;
     }
 
-    int rowStep = (target.row - current.row) > 0 ? 1 : -1;
-    int colStep = (target.col - current.col) > 0 ? 1 : -1;
-
-    vector<Position> adjacentCandidates;
-    adjacentCandidates.push_back(makePos(current.row + rowStep, current.col));   adjacentCandidates.push_back(makePos(current.row, current.col + colStep));
-
-    for (const Position& opponentPos : adjacentCandidates) {
-        if (!board_.isWithinBounds(opponentPos)) {
-            continue;
-        }
-        if (!isCellOccupied(opponentPos, currentTurn_)) {
-            continue;
-        }
-        if (board_.isMoveBlocked(current, opponentPos)) {
-            continue;
-        }
-
-        Position behind=makePos(
-            opponentPos.row + (opponentPos.row - current.row),
-            opponentPos.col + (opponentPos.col - current.col)
-        );
-        bool wallBehind = false;
-        if (!board_.isWithinBounds(behind)) {
-            wallBehind = true;
-        } else if (board_.isMoveBlocked(opponentPos, behind)) {
-            wallBehind = true;
-        }
-        if (!wallBehind) {
-            continue;
-        }
-
-        if (board_.isMoveBlocked(opponentPos, target)) {
-            continue;
-        }
+    const Player player = displayPlayer(state_.currentTurn());
+    Position current = player.getPosition();
+    Position target = player.previewMove(direction);
 
-        players_[currentTurn_].move(direction);
-        handleRedCellInteraction();
-        return true;
+    int destination;
+    MoveError error = state_.pawnDestination(target.row - current.row,
+                                             target.col - current.col,
+                                             destination);
+    if (error != MoveError::None) {
+        cout << messageFor(error) << '\n';
+        return false;
     }
 
-    cout << "Diagonal move requires an adjacent opponent with a blocking wall and a clear diagonal path.\n";
-    return false;
-}
-
-bool Game::isRedCellPosition(const Position& position) const {
-    return (position.row==2&&position.col==2)||(position.row==2&&position.col==6)||(position.row==6&&position.col==2)||(position.row==6&&position.col==6);
+    int swapWith = handleRedCellInteraction(destination);
+    error = playMove(Move::pawn(Board::cellIndex(current), destination, swapWith));
+    if (error != MoveError::None) {
+        cout << messageFor(error) << '\n';
+        return false;
+    }
+    return true;
 }
 
-void Game::handleRedCellInteraction() {
-    Position position = players_[currentTurn_].getPosition();
-    if (!isRedCellPosition(position)) {
-        return;
+// 빨간 칸에 도착하면 자리를 바꿀 플레이어를 고른다. 바꾸지 않으면 Move::kNoSwap.
+int Game::handleRedCellInteraction(int destination) {
+    const Position position = Board::cellPosition(destination);
+    if (!GameState::isRedCellPosition(position)) {
+        return Move::kNoSwap;
     }
 
-    board_.drawBoard(players_);
+    const std::size_t currentTurn = state_.currentTurn();
+    std::array<Position, GameState::kPlayerCount> preview = state_.pawnPositions();
+    preview[currentTurn] = position;
+    renderer_.draw(state_.board(), preview.data(), preview.size());
 
     cout << "You are in the red pixel!\n";
+    const unsigned targets = state_.swapTargets(position);
+    cout << "Players you can switch with:";
+    for (std::size_t i = 0; i < state_.playerCount(); ++i) {
+        if (targets & (1u << i)) {
+            cout << ' ' << (i + 1);
+        }
+    }
+    cout << (targets ? "\n" : " none\n");
 
     auto flushLine = [&]() {
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -338,39 +354,32 @@ void Game::handleRedCellInteraction() {
 
         flushLine();
 
-        if (targetId < 1 || static_cast<std::size_t>(targetId) > players_.size()) {
+        if (targetId < 1 || static_cast<std::size_t>(targetId) > state_.playerCount()) {
             cout << "Invalid player ID. Try again.\n";
             continue;
         }
 
         std::size_t targetIndex = static_cast<std::size_t>(targetId - 1);
-        if (targetIndex == currentTurn_) {
+        if (targetIndex == currentTurn) {
             cout << "Remaining on the red pixel.\n";
-            break;
+            return Move::kNoSwap;
         }
 
-        Position otherPosition = players_[targetIndex].getPosition();
-        auto goalCheck = [&](const Position& pos) {
-            return pos.row == otherPosition.row && pos.col == otherPosition.col;
-        };
-
-        if (!board_.existsPath(position, goalCheck)) {
-            cout << "All paths are blocked by walls. Choose another player.\n";
+        if (!state_.canSwap(position, targetIndex)) {
+            cout << messageFor(MoveError::SwapPathBlocked) << '\n';
             continue;
         }
 
-        players_[targetIndex].setPosition(position);
-        players_[currentTurn_].setPosition(otherPosition);
         cout << "Swapped positions with Player " << (targetIndex + 1) << ".\n";
-        break;
+        return static_cast<int>(targetIndex);
     }
 }
 
 // Handle wall placement command
 
 bool Game::handleWallCommand(int row, char col, char orientation) {
-    if (!players_[currentTurn_].hasWallsRemaining()) {
-        cout << "No walls remaining to place.\n";
+    if (!state_.hasWallsRemaining(state_.currentTurn())) {
+        cout << messageFor(MoveError::NoWallsLeft) << '\n';
         return false;
     }
 
@@ -392,7 +401,7 @@ bool Game::handleWallCommand(int row, char col, char orientation) {
     // 9x9일 때 유효한 벽 위치는 0~7 까지
     if (rowIdx < 0 || rowIdx >= Board::kSize - 1 ||
         colIdx < 0 || colIdx >= Board::kSize - 1) {
-        cout << "Wall position out of range.\n";
+        cout << messageFor(MoveError::WallOutOfRange) << '\n';
         return false;
     }
 
@@ -407,154 +416,20 @@ bool Game::handleWallCommand(int row, char col, char orientation) {
         return false;
     }
 
-    // 3) 보드에 실제로 벽 놓기
+    // 3) 규칙 검사와 배치는 GameState가 한다 (모든 플레이어의 경로 확인 포함)
     Position position=makePos(rowIdx, colIdx);
-    if (!board_.placeWall(position, horizontal)) {
-        cout << "Cannot place a wall at that location.\n";
+    MoveError error = playMove(Move::wall(Board::wallSlot(position, horizontal)));
+    if (error != MoveError::None) {
+        cout << messageFor(error) << '\n';
         return false;
     }
-
-    if (!allPlayersHavePath()) {
-        board_.removeWall(position, horizontal);
-        cout << "That wall blocks every route to a goal for at least one player.\n";
-        return false;
-    }
-
-    // 4) 플레이어가 가진 벽 개수 감소
-    players_[currentTurn_].placeWall();
     return true;
 }
 
-void Game::nextTurn() {
-    if (players_.empty()) {
-        return;
-    }
-    currentTurn_ = (currentTurn_ + 1) % players_.size();
-}
-
-
 void Game::checkGameOver() {
-    for (std::size_t index = 0; index < players_.size(); ++index) {
-        if (hasPlayerReachedGoal(index)) {
-            isGameOver_ = true;
-            winnerName_ = players_[index].getName();
-            std::cout << winnerName_ << " reached the goal!\n";
-            break;
-        }
-    }
-}
-
-bool Game::hasPlayerReachedGoal(std::size_t playerIndex) const {
-    if (playerIndex >= players_.size()) {
-        return false;
-    }
-
-    Position position = players_[playerIndex].getPosition();
-    auto goalCondition = goalConditionForPlayer(playerIndex);
-    return goalCondition(position);
-}
-
-bool Game::isCellOccupied(const Position& position, std::size_t ignoreIndex) const {
-    for (std::size_t index = 0; index < players_.size(); ++index) {
-        if (index == ignoreIndex) {
-            continue;
-        }
-        Position current = players_[index].getPosition();
-        if (current.row == position.row && current.col == position.col) {
-            return true;
-        }
-    }
-    return false;
-}
-
-std::function<bool(const Position&)> Game::goalConditionForPlayer(std::size_t playerIndex) const {
-    if (playerIndex >= playerGoals_.size()) {
-        return [](const Position&) { return false; };
-    }
-
-    GoalType goal = playerGoals_[playerIndex];
-
-    switch (goal) {
-        case GoalType::Row0:
-            return [](const Position& pos) { return pos.row == 0; };
-        case GoalType::RowLast:
-            return [](const Position& pos) { return pos.row == Board::kSize - 1; };
-        case GoalType::Col0:
-            return [](const Position& pos) { return pos.col == 0; };
-        case GoalType::ColLast:
-            return [](const Position& pos) { return pos.col == Board::kSize - 1; };
-        default:
-            return [](const Position&) { return false; };
-    }
-}
-
-bool Game::playerHasPathToGoal(std::size_t playerIndex) const {
-    if (playerIndex >= players_.size()) {
-        return false;
-    }
-
-    auto goalCondition = goalConditionForPlayer(playerIndex);
-    return board_.existsPath(players_[playerIndex].getPosition(), goalCondition);
-}
-
-bool Game::allPlayersHavePath() const {
-    for (std::size_t i = 0; i < players_.size(); ++i) {
-        if (!playerHasPathToGoal(i)) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool Game::canMoveDiagonally(const Position& current,
-                             const Position& target,
-                             const Position& diagonal,
-                             std::size_t movingIndex) const {
-    if (!board_.isWithinBounds(diagonal)) {
-        return false;
-    }
-    if (board_.isMoveBlocked(current, target)) {
-        return false;
-    }
-    if (isCellOccupied(diagonal, movingIndex)) {
-        return false;
-    }
-    if (board_.isMoveBlocked(target, diagonal)) {
-        return false;
-    }
-
-    int primaryRow = target.row - current.row;
-    int primaryCol = target.col - current.col;
-    int diagonalRowDelta = diagonal.row - target.row;
-    int diagonalColDelta = diagonal.col - target.col;
-
-    if (std::abs(primaryRow) + std::abs(primaryCol) != 1) {
-        return false;
-    }
-    if (std::abs(diagonalRowDelta) + std::abs(diagonalColDelta) != 1) {
-        return false;
-    }
-    if (primaryRow != 0 && diagonalColDelta == 0) {
-        return false;
-    }
-    if (primaryCol != 0 && diagonalRowDelta == 0) {
-        return false;
-    }
-    return true;
-}
-
-Game::GoalType Game::determineGoalType(const Position& startPosition) const {
-    if (startPosition.row == 0) {
-        return GoalType::RowLast;
-    }
-    if (startPosition.row == Board::kSize - 1) {
-        return GoalType::Row0;
-    }
-    if (startPosition.col == 0) {
-        return GoalType::ColLast;
-    }
-    if (startPosition.col == Board::kSize - 1) {
-        return GoalType::Col0;
+    if (state_.isGameOver()) {
+        isGameOver_ = true;
+        winnerName_ = seatName(static_cast<std::size_t>(state_.winner()));
+        std::cout << winnerName_ << " reached the goal!\n";
     }
-    return GoalType::RowLast;
 }
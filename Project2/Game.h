@@ -1,60 +1,66 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <array>
 #include <cstddef>
-#include <functional>
 #include <string>
 #include <vector>
 
-#include "Board.h"
+#include "BoardRenderer.h"
+#include "GameRecord.h"
+#include "GameState.h"
+#include "Mcts.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
 #include "Player.h"
+#include "Search.h"
 
 using namespace std;
 
+enum class SeatType {
+    Human,
+    Computer,     // alpha-beta
+    MonteCarlo
+};
+
+struct GameOptions {
+    std::array<SeatType, GameState::kPlayerCount> seats{};  // 기본은 모두 사람
+    SearchLimits search;                                    // 컴퓨터 좌석의 한 수 탐색 제한
+    std::size_t hashMegabytes = 16;                         // 컴퓨터 좌석 치환표 크기
+    BoardRenderer::Mode render = BoardRenderer::Mode::Full;
+    std::string recordPath;                                 // 비어 있지 않으면 이진 기보를 덧붙인다
+    std::string bookPath;                                   // 컴퓨터 좌석이 탐색 전에 찾아볼 오프닝 북
+    std::string evalPath;                                   // 비어 있지 않으면 alpha-beta 좌석이 이 NNUE 망으로 평가
+};
+
+// 콘솔 프런트엔드. 규칙은 전부 GameState가 처리하고 여기서는 입출력만 한다.
 class Game {
 public:
-    Game();
+    explicit Game(const GameOptions& options = GameOptions());
 
     void start();
 
 private:
-    enum class GoalType {
-        Row0,
-        RowLast,
-        Col0,
-        ColLast
-    };
-
     void initializePlayers();
-    void showStatus() const;
+    // 좌석의 이름과 상태를 출력용 Player로 만든다
+    Player displayPlayer(std::size_t index) const;
+    void showStatus();
     bool handleInput();
+    bool playComputerTurn();
+    MoveError playMove(const Move& move);
     bool handleMoveCommand(char direction);
-    bool handleOrthogonalMove(char direction,
-                              const Position& current,
-                              const Position& target);
-    bool handleDiagonalMove(char direction,
-                            const Position& current,
-                            const Position& target);
     bool handleWallCommand(int row, char col, char orientation);
-    void handleRedCellInteraction();
-    bool isRedCellPosition(const Position& position) const;
-    void nextTurn();
+    int handleRedCellInteraction(int destination);
     void checkGameOver();
-    bool hasPlayerReachedGoal(std::size_t playerIndex) const;
-    bool isCellOccupied(const Position& position, std::size_t ignoreIndex) const;
-    std::function<bool(const Position&)> goalConditionForPlayer(std::size_t playerIndex) const;
-    bool playerHasPathToGoal(std::size_t playerIndex) const;
-    bool allPlayersHavePath() const;
-    bool canMoveDiagonally(const Position& current,
-                           const Position& target,
-                           const Position& diagonal,
-                           std::size_t movingIndex) const;
-    GoalType determineGoalType(const Position& startPosition) const;
-
-    Board board_;
-    vector<Player> players_;
-    vector<GoalType> playerGoals_;
-    size_t currentTurn_;
+
+    GameOptions options_;
+    GameState state_;
+    AlphaBetaSearch search_;
+    MctsSearch mcts_;
+    nnue::Network network_;
+    OpeningBook book_;
+    BoardRenderer renderer_;
+    RecordWriter recorder_;
     bool isGameOver_;
     string winnerName_;
     bool skipInputFlush_;
@@ -0,0 +1,447 @@
+#include "GameArchive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "Notation.h"
+
+namespace {
+constexpr char kMagic[8] = {'Q', 'A', 'R', 'C', 'H', 'I', 'V', '1'};
+constexpr std::size_t kAlignment = 8;
+
+std::uint64_t alignUp(std::uint64_t value) {
+    return (value + kAlignment - 1) & ~std::uint64_t{kAlignment - 1};
+}
+
+bool writeBytes(std::FILE* file, const void* bytes, std::size_t size) {
+    return size == 0 || std::fwrite(bytes, 1, size, file) == size;
+}
+
+bool writePadding(std::FILE* file, std::uint64_t& offset) {
+    static const std::uint8_t kZeros[kAlignment] = {};
+    const std::uint64_t aligned = alignUp(offset);
+    const bool ok = writeBytes(file, kZeros, static_cast<std::size_t>(aligned - offset));
+    offset = aligned;
+    return ok;
+}
+
+bool entryLess(const GameArchive::IndexEntry& a, const GameArchive::IndexEntry& b) {
+    if (a.hash != b.hash) return a.hash < b.hash;
+    if (a.game != b.game) return a.game < b.game;
+    return a.ply < b.ply;
+}
+
+// 병합할 때 묶음 하나에서 한 번에 읽어 오는 항목 수
+constexpr std::size_t kMergeBufferEntries = 4096;
+
+// 정렬해서 임시 파일에 쏟은 색인 묶음들. 파일은 닫힐 때 지워진다.
+class SortedRuns {
+public:
+    SortedRuns() = default;
+    SortedRuns(const SortedRuns&) = delete;
+    SortedRuns& operator=(const SortedRuns&) = delete;
+    ~SortedRuns() {
+        for (std::FILE* file : files_) {
+            std::fclose(file);
+        }
+    }
+
+    std::size_t size() const { return files_.size(); }
+
+    // entries를 정렬해 새 임시 파일에 쓰고 비운다 (자리는 다음 묶음에 그대로 쓴다)
+    bool spill(std::vector<GameArchive::IndexEntry>& entries) {
+        std::sort(entries.begin(), entries.end(), entryLess);
+        std::FILE* file = std::tmpfile();
+        if (!file) {
+            return false;
+        }
+        files_.push_back(file);
+        const bool ok = writeBytes(file, entries.data(), entries.size() * sizeof(GameArchive::IndexEntry)) &&
+                        std::fflush(file) == 0;
+        entries.clear();
+        return ok;
+    }
+
+    // 모든 묶음을 (hash, game, ply) 순으로 합쳐 out에 쓴다
+    bool merge(std::FILE* out) {
+        struct Cursor {
+            std::vector<GameArchive::IndexEntry> buffer;
+            std::size_t position = 0;
+        };
+        std::vector<Cursor> cursors(files_.size());
+        auto refill = [this, &cursors](std::size_t run) {
+            Cursor& cursor = cursors[run];
+            cursor.buffer.resize(kMergeBufferEntries);
+            const std::size_t count = std::fread(cursor.buffer.data(), sizeof(GameArchive::IndexEntry),
+                                                 kMergeBufferEntries, files_[run]);
+            cursor.buffer.resize(count);
+            cursor.position = 0;
+            return count > 0;
+        };
+
+        // 각 묶음의 맨 앞 항목을 힙에 두고 가장 작은 것부터 꺼낸다
+        using Head = std::pair<GameArchive::IndexEntry, std::size_t>;
+        auto later = [](const Head& a, const Head& b) { return entryLess(b.first, a.first); };
+        std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+        for (std::size_t run = 0; run < files_.size(); ++run) {
+            if (std::fseek(files_[run], 0, SEEK_SET) != 0) {
+                return false;
+            }
+            if (refill(run)) {
+                heads.push(Head(cursors[run].buffer[0], run));
+            }
+        }
+
+        std::vector<GameArchive::IndexEntry> output;
+        output.reserve(kMergeBufferEntries);
+        bool ok = true;
+        while (ok && !heads.empty()) {
+            const std::size_t run = heads.top().second;
+            output.push_back(heads.top().first);
+            heads.pop();
+            Cursor& cursor = cursors[run];
+            if (++cursor.position < cursor.buffer.size() || refill(run)) {
+                heads.push(Head(cursor.buffer[cursor.position], run));
+            }
+            if (output.size() == kMergeBufferEntries) {
+                ok = writeBytes(out, output.data(), output.size() * sizeof(GameArchive::IndexEntry));
+                output.clear();
+            }
+        }
+        for (std::FILE* file : files_) {
+            ok = ok && !std::ferror(file);
+        }
+        return ok && writeBytes(out, output.data(), output.size() * sizeof(GameArchive::IndexEntry));
+    }
+
+private:
+    std::vector<std::FILE*> files_;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printUsage() {
+    std::cout << "usage: project2 archive build <out> [--run-entries n] <record files...>\n"
+              << "       project2 archive query <archive> [position]\n";
+}
+}  // namespace
+
+struct GameArchive::Header {
+    char magic[8];
+    std::uint64_t gameCount;
+    std::uint64_t recordsOffset;
+    std::uint64_t recordsSize;
+    std::uint64_t gameTableOffset;
+    std::uint64_t indexOffset;
+    std::uint64_t indexCount;
+};
+
+static_assert(sizeof(GameArchive::IndexEntry) == 16, "archive index entries are 16 bytes on disk");
+
+bool GameArchive::build(const std::vector<std::string>& recordFiles, const std::string& path,
+                        const BuildOptions& options, BuildReport& report) {
+    report = BuildReport();
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+
+    // 머리는 자리만 잡아 두고 끝에서 다시 쓴다
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    bool ok = writeBytes(out, &header, sizeof(header));
+    std::uint64_t offset = sizeof(header);
+    header.recordsOffset = offset;
+
+    const std::size_t runEntries = std::max<std::size_t>(1, options.runEntries);
+    std::vector<std::uint64_t> gameOffsets;
+    std::vector<IndexEntry> index;
+    SortedRuns runs;
+    std::uint64_t indexCount = 0;
+    GameState state;
+    Move move;
+
+    for (const std::string& recordFile : recordFiles) {
+        MappedFile input;
+        if (!input.open(recordFile)) {
+            std::fclose(out);
+            return false;
+        }
+        RecordReader reader(input.data(), input.size());
+        record::RecordedGame game;
+        while (ok && reader.next(game)) {
+            // 게임 사이에서만 쏟는다 (깨진 게임은 자기 항목을 되돌려야 하므로)
+            if (index.size() >= runEntries) {
+                ok = runs.spill(index);
+            }
+            const std::uint32_t number = static_cast<std::uint32_t>(gameOffsets.size());
+            const std::uint8_t winner = game.winner == GameState::kNoWinner
+                                            ? record::kNoWinnerByte
+                                            : static_cast<std::uint8_t>(game.winner);
+            const std::size_t indexed = std::min<std::size_t>(game.moveCount,
+                                                              std::numeric_limits<std::uint16_t>::max());
+            const std::size_t mark = index.size();
+
+            // 재생하며 수를 두기 전 국면마다 색인 항목을 만든다 (마지막 국면 포함)
+            state.initializePlayers();
+            bool valid = true;
+            for (std::size_t ply = 0; ply <= game.moveCount; ++ply) {
+                if (ply <= indexed) {
+                    index.push_back(IndexEntry{state.hash(), number, static_cast<std::uint16_t>(ply),
+                                               winner, 0});
+                }
+                if (ply == game.moveCount) {
+                    break;
+                }
+                if (!record::decodeMove(state, game.moves[ply], move) ||
+                    state.apply(move) != MoveError::None) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (!valid || state.winner() != game.winner) {
+                index.resize(mark);
+                ++report.invalid;
+                continue;
+            }
+
+            indexCount += index.size() - mark;
+
+            // 머리부터 승자 바이트까지 원본 그대로 옮긴다
+            const std::uint8_t* begin = game.moves - record::kHeaderSize;
+            const std::size_t size = record::kHeaderSize + game.moveCount + 2;
+            gameOffsets.push_back(offset - header.recordsOffset);
+            ok = writeBytes(out, begin, size);
+            offset += size;
+        }
+        report.skipped += reader.skipped();
+    }
+
+    header.recordsSize = offset - header.recordsOffset;
+    ok = ok && writePadding(out, offset);
+    header.gameTableOffset = offset;
+    header.gameCount = gameOffsets.size();
+    ok = ok && writeBytes(out, gameOffsets.data(), gameOffsets.size() * sizeof(std::uint64_t));
+    offset += gameOffsets.size() * sizeof(std::uint64_t);
+
+    header.indexOffset = offset;
+    header.indexCount = indexCount;
+    if (runs.size() == 0) {
+        std::sort(index.begin(), index.end(), entryLess);
+        ok = ok && writeBytes(out, index.data(), index.size() * sizeof(IndexEntry));
+    } else {
+        ok = ok && (index.empty() || runs.spill(index));
+        std::vector<IndexEntry>().swap(index);
+        ok = ok && runs.merge(out);
+    }
+
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && writeBytes(out, &header, sizeof(header));
+    ok = std::fclose(out) == 0 && ok;
+
+    report.games = header.gameCount;
+    report.positions = header.indexCount;
+    report.runs = runs.size();
+    return ok;
+}
+
+bool GameArchive::open(const std::string& path) {
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    const std::uint64_t size = file_.size();
+    const bool valid =
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.recordsOffset <= size && header.recordsSize <= size - header.recordsOffset &&
+        header.gameTableOffset % kAlignment == 0 && header.gameTableOffset <= size &&
+        header.gameCount <= (size - header.gameTableOffset) / sizeof(std::uint64_t) &&
+        header.indexOffset % kAlignment == 0 && header.indexOffset <= size &&
+        header.indexCount <= (size - header.indexOffset) / sizeof(IndexEntry);
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    records_ = file_.data() + header.recordsOffset;
+    recordsSize_ = header.recordsSize;
+    gameOffsets_ = reinterpret_cast<const std::uint64_t*>(file_.data() + header.gameTableOffset);
+    gameCount_ = header.gameCount;
+    index_ = reinterpret_cast<const IndexEntry*>(file_.data() + header.indexOffset);
+    indexCount_ = header.indexCount;
+    return true;
+}
+
+void GameArchive::close() {
+    file_.close();
+    records_ = nullptr;
+    recordsSize_ = 0;
+    gameOffsets_ = nullptr;
+    gameCount_ = 0;
+    index_ = nullptr;
+    indexCount_ = 0;
+}
+
+bool GameArchive::game(std::uint64_t index, record::RecordedGame& game) const {
+    if (index >= gameCount_ || gameOffsets_[index] >= recordsSize_) {
+        return false;
+    }
+    const std::uint64_t offset = gameOffsets_[index];
+    RecordReader reader(records_ + offset, static_cast<std::size_t>(recordsSize_ - offset));
+    return reader.next(game);
+}
+
+void GameArchive::find(std::uint64_t hash, const IndexEntry*& first, const IndexEntry*& last) const {
+    const IndexEntry* begin = index_;
+    const IndexEntry* end = index_ + indexCount_;
+    first = std::lower_bound(begin, end, hash,
+                             [](const IndexEntry& entry, std::uint64_t key) { return entry.hash < key; });
+    last = std::upper_bound(first, end, hash,
+                            [](std::uint64_t key, const IndexEntry& entry) { return key < entry.hash; });
+}
+
+GameArchive::PositionStats GameArchive::stats(std::uint64_t hash) const {
+    PositionStats stats;
+    const IndexEntry* first;
+    const IndexEntry* last;
+    find(hash, first, last);
+    for (const IndexEntry* entry = first; entry != last; ++entry) {
+        ++stats.occurrences;
+        // 한 게임이 같은 국면을 여러 번 지나가도 한 번만 센다 (게임 번호 순으로 붙어 있다)
+        if (entry != first && entry[-1].game == entry->game) {
+            continue;
+        }
+        ++stats.games;
+        if (entry->winner == record::kNoWinnerByte) {
+            ++stats.draws;
+        } else {
+            ++stats.wins[entry->winner];
+        }
+    }
+    return stats;
+}
+
+namespace {
+int runBuild(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    GameArchive::BuildOptions options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--run-entries" && i + 1 < argc) {
+            const long long value = std::atoll(argv[++i]);
+            if (value < 1) {
+                printUsage();
+                return 1;
+            }
+            options.runEntries = static_cast<std::size_t>(value);
+        } else {
+            inputs.push_back(argument);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    GameArchive::BuildReport report;
+    if (!GameArchive::build(inputs, argv[0], options, report)) {
+        std::cout << "cannot build " << argv[0] << '\n';
+        return 1;
+    }
+    std::cout << "games " << report.games << ", positions " << report.positions
+              << ", skipped " << report.skipped << ", invalid " << report.invalid
+              << ", sorted runs " << report.runs << " in " << secondsSince(start) << " s\n";
+    return 0;
+}
+
+int runQuery(int argc, char** argv) {
+    if (argc < 1) {
+        printUsage();
+        return 1;
+    }
+
+    std::string position = notation::kStartPosition;
+    if (argc > 1) {
+        position.clear();
+        for (int i = 1; i < argc; ++i) {
+            if (i > 1) position += ' ';
+            position += argv[i];
+        }
+    }
+    GameState state;
+    if (!notation::parsePosition(position, state)) {
+        std::cout << "Invalid position \"" << position << "\"\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    GameArchive archive;
+    if (!archive.open(argv[0])) {
+        std::cout << "cannot open archive " << argv[0] << '\n';
+        return 1;
+    }
+    const double openSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    const GameArchive::PositionStats stats = archive.stats(state.hash());
+    const double querySeconds = secondsSince(start);
+
+    std::cout << "archive " << archive.gameCount() << " games, " << archive.indexSize()
+              << " positions (opened in " << openSeconds * 1e6 << " us)\n"
+              << "position " << notation::formatPosition(state) << " hash " << std::hex
+              << std::setw(16) << std::setfill('0') << state.hash() << std::dec << std::setfill(' ')
+              << '\n'
+              << "reached in " << stats.games << " games (" << stats.occurrences << " times, "
+              << querySeconds * 1e6 << " us)\n";
+    if (stats.games == 0) {
+        return 0;
+    }
+    for (std::size_t seat = 0; seat < stats.wins.size(); ++seat) {
+        std::cout << "seat " << (seat + 1) << ": " << stats.wins[seat] << " wins ("
+                  << 100.0 * stats.wins[seat] / stats.games << "%)\n";
+    }
+    std::cout << "draws " << stats.draws << '\n';
+
+    const GameArchive::IndexEntry* first;
+    const GameArchive::IndexEntry* last;
+    archive.find(state.hash(), first, last);
+    std::cout << "first games:";
+    int shown = 0;
+    for (const GameArchive::IndexEntry* entry = first; entry != last && shown < 10; ++entry, ++shown) {
+        std::cout << " #" << entry->game << " ply " << entry->ply;
+    }
+    std::cout << '\n';
+    return 0;
+}
+}  // namespace
+
+int runArchiveCommand(int argc, char** argv) {
+    if (argc >= 1 && std::string(argv[0]) == "build") {
+        return runBuild(argc - 1, argv + 1);
+    }
+    if (argc >= 1 && std::string(argv[0]) == "query") {
+        return runQuery(argc - 1, argv + 1);
+    }
+    printUsage();
+    return 1;
+}
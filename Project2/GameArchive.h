@@ -0,0 +1,87 @@
+#pragma once
+#ifndef GAMEARCHIVE_HPP
+#define GAMEARCHIVE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameRecord.h"
+#include "GameState.h"
+#include "MappedFile.h"
+
+// 기보 여러 개와 국면 색인을 묶은 파일. 통째로 mmap해서 쓰고, 열 때 아무것도 풀지 않는다.
+//
+// 파일 배치 (리틀 엔디언, 구역마다 8바이트 정렬):
+//   Header
+//   기보 바이트       GameRecord 형식 그대로, 검증을 통과한 게임만
+//   게임 표           게임마다 기보 구역 안 시작 위치 (uint64)
+//   색인              게임의 모든 국면(시작 국면 포함)에 대한 IndexEntry, (hash, game, ply) 순
+//
+// 같은 국면을 찾는 질의는 색인 이진 탐색 한 번이고, 승률도 색인만 보고 낸다.
+// 만들 때 색인은 runEntries개씩 정렬해 임시 파일에 쏟고 마지막에 k-way 병합하므로, 메모리는 기보 수와 상관없이
+// 한 묶음만큼만 쓴다.
+class GameArchive {
+public:
+    struct IndexEntry {
+        std::uint64_t hash;    // GameState::hash(), ply번째 수를 두기 전 국면
+        std::uint32_t game;
+        std::uint16_t ply;
+        std::uint8_t winner;   // 그 게임 승자 좌석, 무승부는 record::kNoWinnerByte
+        std::uint8_t reserved;
+    };
+
+    struct PositionStats {
+        std::uint64_t games = 0;        // 이 국면에 도달한 게임 수
+        std::uint64_t occurrences = 0;  // 반복 포함 색인 항목 수
+        std::array<std::uint64_t, GameState::kPlayerCount> wins{};
+        std::uint64_t draws = 0;
+    };
+
+    struct BuildOptions {
+        std::size_t runEntries = std::size_t(1) << 20;  // 메모리에서 정렬하는 색인 묶음 크기 (16 MB)
+    };
+
+    struct BuildReport {
+        std::uint64_t games = 0;
+        std::uint64_t skipped = 0;   // 끊기거나 깨진 게임
+        std::uint64_t invalid = 0;   // 재생해 보니 규칙에 어긋난 게임
+        std::uint64_t positions = 0;
+        std::uint64_t runs = 0;      // 임시 파일로 쏟은 정렬 묶음 수 (0이면 메모리 안에서 끝났다)
+    };
+
+    // 기보 파일들을 검증하며 읽어 묶음 파일을 만든다
+    static bool build(const std::vector<std::string>& recordFiles, const std::string& path,
+                      const BuildOptions& options, BuildReport& report);
+
+    bool open(const std::string& path);
+    void close();
+
+    std::uint64_t gameCount() const { return gameCount_; }
+    std::uint64_t indexSize() const { return indexCount_; }
+
+    bool game(std::uint64_t index, record::RecordedGame& game) const;
+
+    // hash 국면의 색인 항목 [first, last). 게임 번호, 수 순서로 정렬돼 있다.
+    void find(std::uint64_t hash, const IndexEntry*& first, const IndexEntry*& last) const;
+    PositionStats stats(std::uint64_t hash) const;
+
+private:
+    struct Header;
+
+    MappedFile file_;
+    const std::uint8_t* records_ = nullptr;
+    std::uint64_t recordsSize_ = 0;
+    const std::uint64_t* gameOffsets_ = nullptr;
+    std::uint64_t gameCount_ = 0;
+    const IndexEntry* index_ = nullptr;
+    std::uint64_t indexCount_ = 0;
+};
+
+// "project2 archive build <out> [--run-entries n] <record files...>"
+// "project2 archive query <archive> [position]" (국면은 notation 표기, 없으면 시작 국면)
+int runArchiveCommand(int argc, char** argv);
+
+#endif  // GAMEARCHIVE_HPP
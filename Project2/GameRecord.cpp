@@ -0,0 +1,265 @@
+#include "GameRecord.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "MappedFile.h"
+
+namespace {
+constexpr std::uint8_t kPawnBase = 0x80;
+constexpr std::uint8_t kSwapBase = kPawnBase + Board::kCellCount;
+constexpr std::uint8_t kSwapEnd = kSwapBase + GameState::kRedCellCount * GameState::kPlayerCount;
+
+// 자리바꾸기 코드의 빨간 칸 번호는 GameState::redCellPosition 순서
+int redCellNumber(int cell) {
+    for (int i = 0; i < GameState::kRedCellCount; ++i) {
+        if (Board::cellIndex(GameState::redCellPosition(i)) == cell) {
+            return i;
+        }
+    }
+    return -1;
+}
+}  // namespace
+
+namespace record {
+
+std::uint8_t encodeMove(const Move& move) {
+    if (move.isWall()) {
+        return move.to;
+    }
+    if (move.isSwap()) {
+        return static_cast<std::uint8_t>(kSwapBase + redCellNumber(move.to) * GameState::kPlayerCount +
+                                         move.swapWith);
+    }
+    return static_cast<std::uint8_t>(kPawnBase + move.to);
+}
+
+bool decodeMove(const GameState& state, std::uint8_t code, Move& move) {
+    if (code < kPawnBase) {
+        move = Move::wall(code);
+        return true;
+    }
+    const int from = state.pawnCell(state.currentTurn());
+    if (code < kSwapBase) {
+        move = Move::pawn(from, code - kPawnBase);
+        return true;
+    }
+    if (code < kSwapEnd) {
+        const int index = code - kSwapBase;
+        move = Move::pawn(from, Board::cellIndex(GameState::redCellPosition(index / GameState::kPlayerCount)),
+                          index % GameState::kPlayerCount);
+        return true;
+    }
+    return false;
+}
+
+void appendHeader(std::vector<std::uint8_t>& out, const SeatKinds& seats) {
+    out.push_back(kGameMarker);
+    out.push_back(kVersion);
+    out.push_back(static_cast<std::uint8_t>(seats.size()));
+    out.push_back(0);  // 예약
+    out.insert(out.end(), seats.begin(), seats.end());
+}
+
+void appendEnd(std::vector<std::uint8_t>& out, int winner) {
+    out.push_back(kEndMarker);
+    out.push_back(winner == GameState::kNoWinner ? kNoWinnerByte : static_cast<std::uint8_t>(winner));
+}
+
+bool replay(const RecordedGame& game, GameState& state) {
+    state.initializePlayers();
+    Move move;
+    for (std::size_t i = 0; i < game.moveCount; ++i) {
+        if (!decodeMove(state, game.moves[i], move) || state.apply(move) != MoveError::None) {
+            return false;
+        }
+    }
+    return state.winner() == game.winner;
+}
+
+}  // namespace record
+
+RecordWriter::RecordWriter() : file_(nullptr), games_(0), inGame_(false) {}
+
+RecordWriter::~RecordWriter() {
+    close();
+}
+
+bool RecordWriter::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "ab");
+    return file_ != nullptr;
+}
+
+void RecordWriter::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    inGame_ = false;
+}
+
+void RecordWriter::beginGame(const record::SeatKinds& seats) {
+    if (!file_) {
+        return;
+    }
+    std::vector<std::uint8_t> header;
+    record::appendHeader(header, seats);
+    write(header.data(), header.size());
+    inGame_ = true;
+}
+
+// 수마다 바로 내보내서 프로그램이 중간에 죽어도 그때까지 둔 수는 남는다
+void RecordWriter::appendMove(const Move& move) {
+    if (!file_ || !inGame_) {
+        return;
+    }
+    const std::uint8_t code = record::encodeMove(move);
+    write(&code, 1);
+}
+
+void RecordWriter::endGame(int winner) {
+    if (!file_ || !inGame_) {
+        return;
+    }
+    std::vector<std::uint8_t> end;
+    record::appendEnd(end, winner);
+    write(end.data(), end.size());
+    inGame_ = false;
+    ++games_;
+}
+
+void RecordWriter::appendGame(const std::vector<std::uint8_t>& bytes) {
+    if (!file_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fwrite(bytes.data(), 1, bytes.size(), file_);
+    ++games_;
+}
+
+void RecordWriter::write(const std::uint8_t* bytes, std::size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fwrite(bytes, 1, size, file_);
+    std::fflush(file_);
+}
+
+RecordReader::RecordReader(const std::uint8_t* data, std::size_t size)
+    : data_(data), size_(size), offset_(0), skipped_(0) {}
+
+bool RecordReader::next(record::RecordedGame& game) {
+    while (offset_ < size_) {
+        const std::uint8_t* header = data_ + offset_;
+        if (size_ - offset_ < record::kHeaderSize) {
+            ++skipped_;
+            offset_ = size_;
+            return false;
+        }
+        if (header[0] != record::kGameMarker || header[1] != record::kVersion ||
+            header[2] != GameState::kPlayerCount ||
+            std::any_of(header + 4, header + record::kHeaderSize,
+                        [](std::uint8_t seat) { return seat > record::kMonteCarlo; })) {
+            if (!resync()) {
+                return false;
+            }
+            continue;
+        }
+
+        // 수 바이트는 전부 kSwapEnd 아래라서 그 이상인 첫 바이트가 게임 끝 (또는 깨진 곳)
+        const std::uint8_t* moves = header + record::kHeaderSize;
+        const std::uint8_t* end = data_ + size_;
+        const std::uint8_t* cursor = moves;
+        while (cursor < end && *cursor < kSwapEnd) {
+            ++cursor;
+        }
+        if (cursor + 1 >= end || *cursor != record::kEndMarker ||
+            (cursor[1] >= GameState::kPlayerCount && cursor[1] != record::kNoWinnerByte)) {
+            offset_ = static_cast<std::size_t>(cursor - data_);
+            if (cursor < end && *cursor == record::kGameMarker) {
+                ++skipped_;  // 끊긴 게임 바로 뒤에 새 게임이 붙어 있다
+                continue;
+            }
+            if (!resync()) {
+                return false;
+            }
+            continue;
+        }
+
+        std::copy(header + 4, header + record::kHeaderSize, game.seats.begin());
+        game.moves = moves;
+        game.moveCount = static_cast<std::size_t>(cursor - moves);
+        game.winner = cursor[1] == record::kNoWinnerByte ? GameState::kNoWinner : cursor[1];
+        offset_ = static_cast<std::size_t>(cursor + 2 - data_);
+        return true;
+    }
+    return false;
+}
+
+// 깨진 게임 하나를 세고 다음 게임 머리로 건너뛴다
+bool RecordReader::resync() {
+    ++skipped_;
+    const std::size_t from = std::min(offset_ + 1, size_);
+    const void* marker = std::memchr(data_ + from, record::kGameMarker, size_ - from);
+    offset_ = marker ? static_cast<std::size_t>(static_cast<const std::uint8_t*>(marker) - data_) : size_;
+    return marker != nullptr;
+}
+
+int runReplayCommand(int argc, char** argv) {
+    if (argc != 1) {
+        std::cout << "usage: project2 replay <file>\n";
+        return 1;
+    }
+    MappedFile data;
+    if (!data.open(argv[0])) {
+        std::cout << "cannot read " << argv[0] << '\n';
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    record::RecordedGame game;
+
+    // 1) 훑기만: 게임 수, 수 수, 승자 분포
+    auto start = Clock::now();
+    std::uint64_t games = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t wins[GameState::kPlayerCount] = {};
+    std::uint64_t draws = 0;
+    RecordReader scanner(data.data(), data.size());
+    while (scanner.next(game)) {
+        ++games;
+        moves += game.moveCount;
+        if (game.winner == GameState::kNoWinner) {
+            ++draws;
+        } else {
+            ++wins[game.winner];
+        }
+    }
+    const double scanSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // 2) 규칙 검사를 하며 재생
+    start = Clock::now();
+    std::uint64_t invalid = 0;
+    GameState state;
+    RecordReader reader(data.data(), data.size());
+    while (reader.next(game)) {
+        if (!record::replay(game, state)) {
+            ++invalid;
+        }
+    }
+    const double replaySeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "games " << games << ", moves " << moves << ", skipped " << scanner.skipped()
+              << ", " << data.size() << " bytes\n";
+    for (int seat = 0; seat < GameState::kPlayerCount; ++seat) {
+        std::cout << "seat " << (seat + 1) << ": " << wins[seat] << " wins\n";
+    }
+    std::cout << "draws " << draws << '\n'
+              << "scan   " << scanSeconds << " s (" << games / std::max(scanSeconds, 1e-9)
+              << " games/s)\n"
+              << "replay " << replaySeconds << " s (" << games / std::max(replaySeconds, 1e-9)
+              << " games/s, " << moves / std::max(replaySeconds, 1e-9) << " moves/s)\n"
+              << "invalid " << invalid << '\n';
+    return invalid == 0 ? 0 : 1;
+}
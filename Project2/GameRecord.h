@@ -0,0 +1,122 @@
+#pragma once
+#ifndef GAMERECORD_HPP
+#define GAMERECORD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "Move.h"
+
+// 이진 기보 형식. 게임을 그냥 이어 붙인 것이라 파일끼리 cat으로 합쳐도 된다.
+//
+// 게임 하나:
+//   kGameMarker, kVersion, 좌석 수, 좌석 종류 4개      (머리 8바이트)
+//   수마다 1바이트
+//   kEndMarker, 승자 좌석 (무승부/중단은 kNoWinnerByte)
+//
+// 수 바이트:
+//   0x00..0x7F  벽 슬롯 (Board::wallSlot)
+//   0x80..0xD0  폰 이동, 0x80 + 도착 셀
+//   0xD1..0xE0  빨간 칸 자리바꾸기, 0xD1 + 빨간 칸 번호 * 4 + 바꿀 좌석
+// 출발 셀은 재생 중인 국면에서 알 수 있으므로 적지 않는다. 모든 게임은 시작 국면에서 출발한다.
+//
+// kGameMarker는 수 바이트로 나올 수 없어서, 쓰다 끊긴 게임 뒤에 새 게임이 붙어도
+// 읽는 쪽이 다음 머리에서 다시 맞춰 읽는다.
+namespace record {
+
+constexpr std::uint8_t kGameMarker = 0xFE;
+constexpr std::uint8_t kEndMarker = 0xFF;
+constexpr std::uint8_t kVersion = 1;
+constexpr std::uint8_t kNoWinnerByte = 0xFF;
+constexpr std::size_t kHeaderSize = 4 + GameState::kPlayerCount;
+
+enum SeatKind : std::uint8_t {
+    kHuman,
+    kAlphaBeta,
+    kMonteCarlo
+};
+
+using SeatKinds = std::array<std::uint8_t, GameState::kPlayerCount>;
+
+std::uint8_t encodeMove(const Move& move);
+// state의 현재 차례 플레이어가 둔 수로 해석한다. 수 바이트가 아니면 false.
+bool decodeMove(const GameState& state, std::uint8_t code, Move& move);
+
+// 메모리 버퍼에 게임 하나를 만든다 (여러 스레드가 각자 만들고 RecordWriter::appendGame으로 쓴다)
+void appendHeader(std::vector<std::uint8_t>& out, const SeatKinds& seats);
+void appendEnd(std::vector<std::uint8_t>& out, int winner);
+
+// 읽은 게임 하나. moves는 읽는 버퍼를 그대로 가리킨다.
+struct RecordedGame {
+    SeatKinds seats{};
+    const std::uint8_t* moves = nullptr;
+    std::size_t moveCount = 0;
+    int winner = GameState::kNoWinner;
+};
+
+// 시작 국면에서 game의 수를 차례로 둔다. 규칙에 어긋나는 수가 나오면 false (state는 그 직전 국면).
+bool replay(const RecordedGame& game, GameState& state);
+
+}  // namespace record
+
+// 덧붙이기 전용 기보 파일. 한 게임을 수 단위로 흘려 쓰거나(beginGame/appendMove/endGame)
+// 미리 만든 게임을 통째로 쓴다(appendGame). appendGame만 여러 스레드에서 불러도 된다.
+class RecordWriter {
+public:
+    RecordWriter();
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file_ != nullptr; }
+
+    void beginGame(const record::SeatKinds& seats);
+    void appendMove(const Move& move);
+    void endGame(int winner);
+
+    void appendGame(const std::vector<std::uint8_t>& bytes);
+
+    std::uint64_t gamesWritten() const { return games_; }
+
+private:
+    void write(const std::uint8_t* bytes, std::size_t size);
+
+    std::FILE* file_;
+    std::mutex mutex_;
+    std::uint64_t games_;
+    bool inGame_;
+};
+
+// 메모리에 있는 기보를 게임 단위로 훑는다. 할당 없이 버퍼 안을 가리키는 RecordedGame을 돌려준다.
+class RecordReader {
+public:
+    RecordReader(const std::uint8_t* data, std::size_t size);
+
+    // 다음 완결된 게임. 끊기거나 깨진 게임은 건너뛰고 skipped()에 센다.
+    bool next(record::RecordedGame& game);
+
+    std::uint64_t skipped() const { return skipped_; }
+
+private:
+    bool resync();
+
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t offset_;
+    std::uint64_t skipped_;
+};
+
+// "project2 replay <file>" 명령. 기보를 훑는 속도와 GameState로 재생하는 속도를 재고
+// 규칙에 어긋난 게임 수를 출력한다.
+int runReplayCommand(int argc, char** argv);
+
+#endif  // GAMERECORD_HPP
@@ -0,0 +1,679 @@
+#include "GameState.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+namespace {
+inline Position makePos(int r, int c){
+    Position p;
+    p.row=r;
+    p.col=c;
+    return p;
+}
+
+// 방향 키 8개에 대응하는 (행, 열) 변화량
+const int kPawnDirections[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+    {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+}  // namespace
+
+template <int N> constexpr int BasicGameState<N>::kPlayerCount;
+template <int N> constexpr int BasicGameState<N>::kWallsPerPlayer;
+template <int N> constexpr int BasicGameState<N>::kHistoryCapacity;
+template <int N> constexpr int BasicGameState<N>::kNoWinner;
+template <int N> constexpr int BasicGameState<N>::kRedCellCount;
+
+template <int N>
+BasicGameState<N>::BasicGameState() : hash_(0), history_{}, historyEnd_(0), historySize_(0) {
+    initializePlayers();
+}
+
+// Initialize players at their starting positions
+
+template <int N>
+void BasicGameState<N>::initializePlayers() {
+    board_.reset();
+    seats_ = Seats();
+    seats_.winner = kNoWinner;
+
+    const int middle = Board::kSize / 2;
+    const Position starts[kPlayerCount] = {
+        makePos(middle, 0),
+        makePos(middle, Board::kSize - 1),
+        makePos(0, middle),
+        makePos(Board::kSize - 1, middle)
+    };
+    for (int i = 0; i < kPlayerCount; ++i) {
+        seats_.cell[i] = static_cast<std::uint8_t>(Board::cellIndex(starts[i]));
+        seats_.walls[i] = static_cast<std::uint8_t>(kWallsPerPlayer);
+        seats_.goal[i] = static_cast<std::uint8_t>(determineGoalType(starts[i]));
+        seats_.occupied.set(seats_.cell[i]);
+    }
+
+    resetHistory();
+}
+
+template <int N>
+bool BasicGameState<N>::setPosition(const Position* pawns, const int* wallsRemaining,
+                            const std::vector<int>& wallSlots, std::size_t turn) {
+    initializePlayers();
+    if (turn >= kPlayerCount) {
+        return false;
+    }
+
+    // 좌석별 목표는 시작 위치로 정해지므로 목표는 그대로 두고 말과 벽 수만 바꾼다
+    seats_.occupied = CellSet();
+    for (std::size_t i = 0; i < kPlayerCount; ++i) {
+        if (!board_.isWithinBounds(pawns[i]) ||
+            wallsRemaining[i] < 0 || wallsRemaining[i] > kWallsPerPlayer ||
+            seats_.occupied.test(Board::cellIndex(pawns[i]))) {
+            initializePlayers();
+            return false;
+        }
+        seats_.cell[i] = static_cast<std::uint8_t>(Board::cellIndex(pawns[i]));
+        seats_.walls[i] = static_cast<std::uint8_t>(wallsRemaining[i]);
+        seats_.occupied.set(seats_.cell[i]);
+    }
+
+    for (int slot : wallSlots) {
+        if (slot < 0 || slot >= Board::kWallSlotCount ||
+            !board_.placeWall(Board::wallSlotPosition(slot), Board::isHorizontalSlot(slot))) {
+            initializePlayers();
+            return false;
+        }
+    }
+    if (!allPlayersHavePath()) {
+        initializePlayers();
+        return false;
+    }
+
+    seats_.turn = static_cast<std::uint8_t>(turn);
+    updateWinner();
+    resetHistory();
+    return true;
+}
+
+template <int N>
+MoveError BasicGameState<N>::pawnDestination(int rowDelta, int colDelta, int& destination) const {
+    if (std::abs(rowDelta) > 1 || std::abs(colDelta) > 1 || (rowDelta == 0 && colDelta == 0)) {
+        return MoveError::IllegalPawnMove;
+    }
+
+    Position current = pawnPosition(seats_.turn);
+    Position target = makePos(current.row + rowDelta, current.col + colDelta);
+
+    if (!board_.isWithinBounds(target)) {
+        return MoveError::OutOfBounds;
+    }
+
+    bool isDiagonal = (rowDelta != 0) && (colDelta != 0);
+    if (isDiagonal) {
+        return resolveDiagonalMove(current, target, destination);
+    }
+
+    return resolveOrthogonalMove(current, target, destination);
+}
+
+template <int N>
+MoveError BasicGameState<N>::resolveOrthogonalMove(const Position& current,
+                                           const Position& target,
+                                           int& destination) const {
+    if (board_.isMoveBlocked(current, target)) {
+        return MoveError::Blocked;
+    }
+
+    if (isCellOccupied(target, seats_.turn)) {
+        Position jumpTarget=makePos(
+            target.row + (target.row - current.row),
+            target.col + (target.col - current.col)
+        );
+
+        if (!board_.isWithinBounds(jumpTarget)) {
+            return MoveError::JumpOutOfBounds;
+        }
+
+        if (board_.isMoveBlocked(target, jumpTarget)) {
+            return MoveError::JumpBlocked;
+        }
+
+        if (isCellOccupied(jumpTarget, seats_.turn)) {
+            return MoveError::JumpOccupied;
+        }
+
+        destination = Board::cellIndex(jumpTarget);
+        return MoveError::None;
+    }
+
+    destination = Board::cellIndex(target);
+    return MoveError::None;
+}
+
+template <int N>
+MoveError BasicGameState<N>::resolveDiagonalMove(const Position& current,
+                                         const Position& target,
+                                         int& destination) const {
+    if (isCellOccupied(target, seats_.turn)) {
+        return MoveError::TargetOccupied;
+    }
+
+    int rowStep = (target.row - current.row) > 0 ? 1 : -1;
+    int colStep = (target.col - current.col) > 0 ? 1 : -1;
+
+    const Position adjacentCandidates[2] = {
+        makePos(current.row + rowStep, current.col),
+        makePos(current.row, current.col + colStep)
+    };
+
+    for (const Position& opponentPos : adjacentCandidates) {
+        if (!board_.isWithinBounds(opponentPos)) {
+            continue;
+        }
+        if (!isCellOccupied(opponentPos, seats_.turn)) {
+            continue;
+        }
+        if (board_.isMoveBlocked(current, opponentPos)) {
+            continue;
+        }
+
+        Position behind=makePos(
+            opponentPos.row + (opponentPos.row - current.row),
+            opponentPos.col + (opponentPos.col - current.col)
+        );
+        bool wallBehind = false;
+        if (!board_.isWithinBounds(behind)) {
+            wallBehind = true;
+        } else if (board_.isMoveBlocked(opponentPos, behind)) {
+            wallBehind = true;
+        }
+        if (!wallBehind) {
+            continue;
+        }
+
+        if (board_.isMoveBlocked(opponentPos, target)) {
+            continue;
+        }
+
+        destination = Board::cellIndex(target);
+        return MoveError::None;
+    }
+
+    return MoveError::DiagonalNotAllowed;
+}
+
+template <int N>
+MoveError BasicGameState<N>::checkPawnMove(const Move& move) const {
+    if (isGameOver()) {
+        return MoveError::GameOver;
+    }
+
+    if (move.from != seats_.cell[seats_.turn]) {
+        return MoveError::IllegalPawnMove;
+    }
+
+    // 8방향 중 하나가 이 도착 셀로 풀려야 한다 (점프 포함)
+    bool reachable = false;
+    for (const auto& direction : kPawnDirections) {
+        int destination;
+        if (pawnDestination(direction[0], direction[1], destination) == MoveError::None &&
+            destination == move.to) {
+            reachable = true;
+            break;
+        }
+    }
+    if (!reachable) {
+        return MoveError::IllegalPawnMove;
+    }
+
+    const Position target = Board::cellPosition(move.to);
+    if (move.swapWith == Move::kNoSwap) {
+        return MoveError::None;
+    }
+    if (!isRedCellPosition(target) ||
+        move.swapWith >= kPlayerCount ||
+        move.swapWith == seats_.turn) {
+        return MoveError::InvalidSwapTarget;
+    }
+    if (!canSwap(target, move.swapWith)) {
+        return MoveError::SwapPathBlocked;
+    }
+    return MoveError::None;
+}
+
+template <int N>
+bool BasicGameState<N>::canSwap(const Position& from, std::size_t targetIndex) const {
+    if (targetIndex >= kPlayerCount) {
+        return false;
+    }
+    return board_.isWithinBounds(from) && board_.connected(Board::cellIndex(from), seats_.cell[targetIndex]);
+}
+
+template <int N>
+unsigned BasicGameState<N>::swapTargets(const Position& from) const {
+    if (!board_.isWithinBounds(from)) {
+        return 0;
+    }
+    const int component = board_.componentOf(Board::cellIndex(from));
+    unsigned targets = 0;
+    for (int other = 0; other < kPlayerCount; ++other) {
+        if (other != seats_.turn && board_.componentOf(seats_.cell[other]) == component) {
+            targets |= 1u << other;
+        }
+    }
+    return targets;
+}
+
+template <int N>
+bool BasicGameState<N>::isRedCellPosition(const Position& position) {
+    const bool nearRow = position.row == 2 || position.row == N - 3;
+    const bool nearCol = position.col == 2 || position.col == N - 3;
+    return nearRow && nearCol;
+}
+
+template <int N>
+Position BasicGameState<N>::redCellPosition(int index) {
+    return makePos(index < 2 ? 2 : N - 3, index % 2 == 0 ? 2 : N - 3);
+}
+
+template <int N>
+MoveError BasicGameState<N>::checkWall(const Position& position, bool horizontal) const {
+    if (!hasWallsRemaining(seats_.turn)) {
+        return MoveError::NoWallsLeft;
+    }
+    if (!board_.isWallSlot(position)) {
+        return MoveError::WallOutOfRange;
+    }
+    if (!board_.canPlaceWall(position, horizontal)) {
+        return MoveError::WallOverlaps;
+    }
+    return MoveError::None;
+}
+
+template <int N>
+void BasicGameState<N>::legalMoves(MoveList& moves) const {
+    moves.clear();
+    if (isGameOver()) {
+        return;
+    }
+
+    generatePawnMoves(moves);
+    generateWallMoves(moves);
+}
+
+template <int N>
+void BasicGameState<N>::legalPawnMoves(MoveList& moves) const {
+    moves.clear();
+    if (isGameOver()) {
+        return;
+    }
+
+    generatePawnMoves(moves);
+}
+
+template <int N>
+void BasicGameState<N>::generatePawnMoves(MoveList& moves) const {
+    const int from = seats_.cell[seats_.turn];
+    CellSet occupied = seats_.occupied;
+    occupied.reset(from);
+
+    auto addPawnMove = [&](int to) {
+        moves.push(Move::pawn(from, to));
+        const Position target = Board::cellPosition(to);
+        if (!isRedCellPosition(target)) {
+            return;
+        }
+        const unsigned targets = swapTargets(target);
+        for (int other = 0; other < kPlayerCount; ++other) {
+            if (targets & (1u << other)) {
+                moves.push(Move::pawn(from, to, other));
+            }
+        }
+    };
+
+    // 한 칸 이동, 막혀 있지 않은 상대 너머로 점프
+    static const typename Board::Direction kOrthogonal[4] = {
+        Board::kNorth, Board::kSouth, Board::kWest, Board::kEast
+    };
+    for (typename Board::Direction direction : kOrthogonal) {
+        if (!board_.canStep(from, direction)) {
+            continue;
+        }
+        const int target = Board::stepCell(from, direction);
+        if (!occupied.test(target)) {
+            addPawnMove(target);
+            continue;
+        }
+        if (board_.canStep(target, direction)) {
+            const int jump = Board::stepCell(target, direction);
+            if (!occupied.test(jump)) {
+                addPawnMove(jump);
+            }
+        }
+    }
+
+    // 대각선: 옆 칸 상대 뒤가 벽이나 테두리로 막혀 있을 때 비켜 가기
+    const Position current = Board::cellPosition(from);
+    static const typename Board::Direction kVertical[2] = {Board::kNorth, Board::kSouth};
+    static const typename Board::Direction kHorizontal[2] = {Board::kWest, Board::kEast};
+    for (int v = 0; v < 2; ++v) {
+        for (int h = 0; h < 2; ++h) {
+            Position target;
+            target.row = current.row + (v == 0 ? -1 : 1);
+            target.col = current.col + (h == 0 ? -1 : 1);
+            if (!board_.isWithinBounds(target)) {
+                continue;
+            }
+            const int to = Board::cellIndex(target);
+            if (occupied.test(to)) {
+                continue;
+            }
+            if (canSideStep(from, kVertical[v], kHorizontal[h], occupied) ||
+                canSideStep(from, kHorizontal[h], kVertical[v], occupied)) {
+                addPawnMove(to);
+            }
+        }
+    }
+}
+
+template <int N>
+bool BasicGameState<N>::canSideStep(int from, typename Board::Direction toward, typename Board::Direction side,
+                            const CellSet& occupied) const {
+    if (!board_.canStep(from, toward)) {
+        return false;
+    }
+    const int opponent = Board::stepCell(from, toward);
+    return occupied.test(opponent) &&
+           !board_.canStep(opponent, toward) &&
+           board_.canStep(opponent, side);
+}
+
+template <int N>
+void BasicGameState<N>::generateWallMoves(MoveList& moves) const {
+    typename Board::WallMask legal[2];
+    legalWalls(legal[0], legal[1]);
+    for (int orientation = 0; orientation < 2; ++orientation) {
+        const int base = orientation == 0 ? 0 : Board::kWallGrid * Board::kWallGrid;
+        while (!maskEmpty(legal[orientation])) {
+            moves.push(Move::wall(base + maskPopLowest(legal[orientation])));
+        }
+    }
+}
+
+template <int N>
+void BasicGameState<N>::legalWalls(typename Board::WallMask& horizontal,
+                                   typename Board::WallMask& vertical) const {
+    if (isGameOver() || !hasWallsRemaining(seats_.turn)) {
+        horizontal = vertical = typename Board::WallMask{};
+        return;
+    }
+    Position starts[kPlayerCount];
+    GoalType goals[kPlayerCount];
+    pathTargets(starts, goals);
+    board_.legalWallSlots(starts, goals, kPlayerCount, horizontal, vertical);
+}
+
+template <int N>
+void BasicGameState<N>::pathTargets(Position* starts, GoalType* goals) const {
+    for (int i = 0; i < kPlayerCount; ++i) {
+        starts[i] = pawnPosition(i);
+        goals[i] = goalOf(i);
+    }
+}
+
+template <int N>
+MoveError BasicGameState<N>::checkMove(const Move& move) const {
+    if (isGameOver()) {
+        return MoveError::GameOver;
+    }
+
+    if (move.isWall()) {
+        if (move.wallSlot() >= Board::kWallSlotCount) {
+            return MoveError::WallOutOfRange;
+        }
+        const Position position = Board::wallSlotPosition(move.wallSlot());
+        const bool horizontal = Board::isHorizontalSlot(move.wallSlot());
+        MoveError error = checkWall(position, horizontal);
+        if (error != MoveError::None) {
+            return error;
+        }
+        // 벽을 놓아 보지 않고 경로만 확인한다
+        if (!wallKeepsPaths(position, horizontal)) {
+            return MoveError::WallBlocksPath;
+        }
+    } else {
+        MoveError error = checkPawnMove(move);
+        if (error != MoveError::None) {
+            return error;
+        }
+    }
+    return MoveError::None;
+}
+
+template <int N>
+MoveError BasicGameState<N>::apply(const Move& move) {
+    const MoveError error = checkMove(move);
+    if (error == MoveError::None) {
+        makeMove(move);
+    }
+    return error;
+}
+
+template <int N>
+void BasicGameState<N>::makeMove(const Move& move) {
+    const int seat = seats_.turn;
+    std::uint64_t nextHash = hash_;
+
+    if (move.isWall()) {
+        board_.placeWall(Board::wallSlotPosition(move.wallSlot()), Board::isHorizontalSlot(move.wallSlot()));
+        nextHash ^= Zobrist::wall(move.wallSlot()) ^
+                    Zobrist::wallsRemaining(seat, seats_.walls[seat]);
+        --seats_.walls[seat];
+        nextHash ^= Zobrist::wallsRemaining(seat, seats_.walls[seat]);
+    } else {
+        if (move.isSwap()) {
+            const int otherCell = seats_.cell[move.swapWith];
+            nextHash ^= Zobrist::pawn(seat, move.from) ^ Zobrist::pawn(seat, otherCell) ^
+                        Zobrist::pawn(move.swapWith, otherCell) ^ Zobrist::pawn(move.swapWith, move.to);
+            placePawn(move.swapWith, move.to);
+            placePawn(seat, otherCell);
+        } else {
+            nextHash ^= Zobrist::pawn(seat, move.from) ^ Zobrist::pawn(seat, move.to);
+            placePawn(seat, move.to);
+        }
+    }
+
+    updateWinner();
+    if (!isGameOver()) {
+        seats_.turn = static_cast<std::uint8_t>((seat + 1) % kPlayerCount);
+        nextHash ^= Zobrist::turn(seat) ^ Zobrist::turn(seats_.turn);
+    }
+    history_[historyEnd_ % kHistoryCapacity] = hash_;
+    ++historyEnd_;
+    historySize_ = std::min<std::uint32_t>(historySize_ + 1, kHistoryCapacity);
+    hash_ = nextHash;
+}
+
+template <int N>
+void BasicGameState<N>::unmakeMove(const Move& move) {
+    // 해시는 기록에서 꺼내지 않고 makeMove와 같은 키를 다시 XOR해서 되돌린다 (기록이 고리라 넘칠 수 있다)
+    // 승자가 난 수는 턴을 넘기지 않았다
+    if (!isGameOver()) {
+        const std::uint8_t previous = static_cast<std::uint8_t>((seats_.turn + kPlayerCount - 1) % kPlayerCount);
+        hash_ ^= Zobrist::turn(seats_.turn) ^ Zobrist::turn(previous);
+        seats_.turn = previous;
+    }
+    seats_.winner = kNoWinner;
+    if (historyEnd_ > 0) {
+        --historyEnd_;
+        historySize_ = historySize_ > 0 ? historySize_ - 1 : 0;
+    }
+
+    const int seat = seats_.turn;
+    if (move.isWall()) {
+        board_.removeWall(Board::wallSlotPosition(move.wallSlot()),
+                          Board::isHorizontalSlot(move.wallSlot()));
+        hash_ ^= Zobrist::wall(move.wallSlot()) ^ Zobrist::wallsRemaining(seat, seats_.walls[seat]);
+        ++seats_.walls[seat];
+        hash_ ^= Zobrist::wallsRemaining(seat, seats_.walls[seat]);
+        return;
+    }
+
+    if (move.isSwap()) {
+        const int otherCell = seats_.cell[seat];
+        hash_ ^= Zobrist::pawn(seat, move.from) ^ Zobrist::pawn(seat, otherCell) ^
+                 Zobrist::pawn(move.swapWith, otherCell) ^ Zobrist::pawn(move.swapWith, move.to);
+        placePawn(seat, move.from);
+        placePawn(move.swapWith, otherCell);
+        return;
+    }
+    hash_ ^= Zobrist::pawn(seat, move.from) ^ Zobrist::pawn(seat, move.to);
+    placePawn(seat, move.from);
+}
+
+// 폰 하나를 옮긴다. 자리바꾸기는 두 폰을 차례로 옮기므로 점유 비트는 떠나는 셀이
+// 다른 폰의 셀이 아닐 때만 지운다.
+template <int N>
+void BasicGameState<N>::placePawn(std::size_t playerIndex, int cell) {
+    const int previous = seats_.cell[playerIndex];
+    seats_.cell[playerIndex] = static_cast<std::uint8_t>(cell);
+    bool shared = false;
+    for (int i = 0; i < kPlayerCount; ++i) {
+        shared |= static_cast<std::size_t>(i) != playerIndex && seats_.cell[i] == previous;
+    }
+    if (!shared) {
+        seats_.occupied.reset(previous);
+    }
+    seats_.occupied.set(cell);
+}
+
+template <int N>
+std::array<Position, BasicGameState<N>::kPlayerCount> BasicGameState<N>::pawnPositions() const {
+    std::array<Position, kPlayerCount> positions;
+    for (int i = 0; i < kPlayerCount; ++i) {
+        positions[i] = pawnPosition(i);
+    }
+    return positions;
+}
+
+template <int N>
+int BasicGameState<N>::repetitionCount(int plies) const {
+    const std::uint32_t window =
+        std::min<std::uint32_t>(historySize_, static_cast<std::uint32_t>(std::max(plies, 0)));
+    int count = 0;
+    for (std::uint32_t back = kPlayerCount; back <= window; back += kPlayerCount) {
+        if (history_[(historyEnd_ - back) % kHistoryCapacity] == hash_) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <int N>
+std::uint64_t BasicGameState<N>::computeHash() const {
+    std::uint64_t hash = Zobrist::turn(seats_.turn);
+    for (int seat = 0; seat < kPlayerCount; ++seat) {
+        hash ^= Zobrist::pawn(seat, seats_.cell[seat]);
+        hash ^= Zobrist::wallsRemaining(seat, seats_.walls[seat]);
+    }
+    for (int slot = 0; slot < Board::kWallSlotCount; ++slot) {
+        if (board_.hasWall(Board::wallSlotPosition(slot), Board::isHorizontalSlot(slot))) {
+            hash ^= Zobrist::wall(slot);
+        }
+    }
+    return hash;
+}
+
+template <int N>
+void BasicGameState<N>::resetHistory() {
+    hash_ = computeHash();
+    historyEnd_ = 0;
+    historySize_ = 0;
+}
+
+template <int N>
+bool BasicGameState<N>::wallKeepsPaths(const Position& position, bool horizontal) const {
+    Position starts[kPlayerCount];
+    GoalType goals[kPlayerCount];
+    pathTargets(starts, goals);
+    return board_.wallKeepsPaths(position, horizontal, starts, goals, kPlayerCount);
+}
+
+template <int N>
+void BasicGameState<N>::updateWinner() {
+    for (std::size_t index = 0; index < kPlayerCount; ++index) {
+        if (hasPlayerReachedGoal(index)) {
+            seats_.winner = static_cast<std::int8_t>(index);
+            return;
+        }
+    }
+}
+
+template <int N>
+bool BasicGameState<N>::hasPlayerReachedGoal(std::size_t playerIndex) const {
+    if (playerIndex >= kPlayerCount) {
+        return false;
+    }
+
+    return Board::isGoalCell(seats_.cell[playerIndex], goalOf(playerIndex));
+}
+
+template <int N>
+bool BasicGameState<N>::isCellOccupied(const Position& position, std::size_t ignoreIndex) const {
+    if (!board_.isWithinBounds(position)) {
+        return false;
+    }
+    // 두 폰이 한 셀에 있는 일은 없으므로 ignoreIndex의 셀만 빼면 된다
+    const int cell = Board::cellIndex(position);
+    return seats_.occupied.test(cell) && (ignoreIndex >= kPlayerCount || seats_.cell[ignoreIndex] != cell);
+}
+
+template <int N>
+CellSet BasicGameState<N>::goalMaskForPlayer(std::size_t playerIndex) const {
+    if (playerIndex >= kPlayerCount) {
+        return CellSet();
+    }
+    return Board::goalMask(goalOf(playerIndex));
+}
+
+template <int N>
+bool BasicGameState<N>::playerHasPathToGoal(std::size_t playerIndex) const {
+    if (playerIndex >= kPlayerCount) {
+        return false;
+    }
+
+    // Board가 벽 배치마다 갱신하는 거리 맵을 읽기만 한다
+    return board_.distanceToGoal(seats_.cell[playerIndex], goalOf(playerIndex)) != Board::kUnreachable;
+}
+
+template <int N>
+bool BasicGameState<N>::allPlayersHavePath() const {
+    for (std::size_t i = 0; i < kPlayerCount; ++i) {
+        if (!playerHasPathToGoal(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+GoalType BasicGameState<N>::determineGoalType(const Position& startPosition) const {
+    if (startPosition.row == 0) {
+        return GoalType::RowLast;
+    }
+    if (startPosition.row == Board::kSize - 1) {
+        return GoalType::Row0;
+    }
+    if (startPosition.col == 0) {
+        return GoalType::ColLast;
+    }
+    if (startPosition.col == Board::kSize - 1) {
+        return GoalType::Col0;
+    }
+    return GoalType::RowLast;
+}
+
+template class BasicGameState<5>;
+template class BasicGameState<7>;
+template class BasicGameState<9>;
+template class BasicGameState<11>;
@@ -0,0 +1,162 @@
+#pragma once
+#ifndef GAMESTATE_HPP
+#define GAMESTATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+#include "Move.h"
+#include "Zobrist.h"
+
+// 규칙 검사 결과. 콘솔 문구는 Game이 붙인다.
+enum class MoveError {
+    None,
+    GameOver,
+    OutOfBounds,
+    Blocked,
+    JumpOutOfBounds,
+    JumpBlocked,
+    JumpOccupied,
+    TargetOccupied,
+    DiagonalNotAllowed,
+    IllegalPawnMove,
+    InvalidSwapTarget,
+    SwapPathBlocked,
+    NoWallsLeft,
+    WallOutOfRange,
+    WallOverlaps,
+    WallBlocksPath
+};
+
+// 콘솔 입출력 없이 규칙만 다루는 게임 상태. 값 타입이라 복사해서 시뮬레이션에 쓸 수 있다.
+// 보드 크기 N마다 따로 인스턴스화된다 (GameState.cpp: 5, 7, 9, 11). 게임 본편과 엔진은 9x9 GameState를 쓴다.
+// 이름 같은 표시용 데이터는 갖지 않는다 (Game이 좌석 번호로 만든다).
+template <int N>
+class BasicGameState {
+public:
+    using Board = BasicBoard<N>;
+    // 폰 도착 셀 최대 8곳 x (제자리 + 자리바꾸기 3가지) + 벽 슬롯
+    using MoveList = BasicMoveList<8 * 4 + Board::kWallSlotCount>;
+
+    static constexpr int kPlayerCount = 4;
+    static constexpr int kWallsPerPlayer = N + 1;  // 9x9에서 10개
+    static constexpr int kNoWinner = -1;
+    // repetitionCount가 돌아보는 최근 수. 기록은 고정 크기 고리라 복사에 힙 할당이 없다.
+    static constexpr int kHistoryCapacity = 32;
+    static constexpr int kRedCellCount = 4;
+
+    BasicGameState();
+
+    // 네 플레이어를 시작 위치에 놓고 벽을 모두 치운다
+    void initializePlayers();
+    // 임의 국면을 만든다 (perft, 기보 재생용). 규칙에 맞지 않으면 false를 돌려주고 시작 배치로 돌아간다.
+    bool setPosition(const Position* pawns, const int* wallsRemaining,
+                     const std::vector<int>& wallSlots, std::size_t turn);
+
+    const Board& board() const { return board_; }
+    std::size_t playerCount() const { return kPlayerCount; }
+    std::size_t currentTurn() const { return seats_.turn; }
+    GoalType goalOf(std::size_t playerIndex) const { return static_cast<GoalType>(seats_.goal[playerIndex]); }
+    int winner() const { return seats_.winner; }
+    bool isGameOver() const { return seats_.winner != kNoWinner; }
+
+    int pawnCell(std::size_t playerIndex) const { return seats_.cell[playerIndex]; }
+    Position pawnPosition(std::size_t playerIndex) const { return Board::cellPosition(seats_.cell[playerIndex]); }
+    std::array<Position, kPlayerCount> pawnPositions() const;
+    int wallsRemaining(std::size_t playerIndex) const { return seats_.walls[playerIndex]; }
+    bool hasWallsRemaining(std::size_t playerIndex) const { return seats_.walls[playerIndex] != 0; }
+    // 네 폰이 있는 셀
+    const CellSet& occupiedCells() const { return seats_.occupied; }
+
+    // 폰 위치, 벽, 남은 벽 수, 차례를 덮는 Zobrist 해시. apply/undo마다 증분 갱신된다.
+    std::uint64_t hash() const { return hash_; }
+    // 지금 국면이 최근 plies수 (kHistoryCapacity까지, setPosition 이후만) 안에 앞서 몇 번 나왔는지.
+    // 차례가 해시에 들어 있어 kPlayerCount수 간격으로만 비교한다.
+    int repetitionCount(int plies = kHistoryCapacity) const;
+
+    // 현재 플레이어가 (rowDelta, colDelta) 방향으로 움직일 때 실제 도착 셀 (점프 포함)
+    MoveError pawnDestination(int rowDelta, int colDelta, int& destination) const;
+    MoveError checkPawnMove(const Move& move) const;
+    bool canSwap(const Position& from, std::size_t targetIndex) const;
+    // from(빨간 칸)에서 현재 플레이어가 자리를 바꿀 수 있는 좌석들 (비트 i = 좌석 i)
+    unsigned swapTargets(const Position& from) const;
+    static bool isRedCellPosition(const Position& position);
+    // 빨간 칸은 네 모서리에서 대각선으로 두 칸 안쪽 (5x5에서는 넷이 가운데 한 칸으로 겹친다)
+    static Position redCellPosition(int index);
+
+    // 현재 플레이어의 모든 합법수 (폰 이동, 점프, 대각선, 자리바꾸기, 벽)
+    void legalMoves(MoveList& moves) const;
+    // 폰 이동만 (롤아웃처럼 벽을 보지 않는 곳에서 쓴다)
+    void legalPawnMoves(MoveList& moves) const;
+    // 현재 플레이어가 놓을 수 있는 벽 슬롯 전부를 방향별 비트마스크로 (Board::wallSlot 순서의 줄 우선 번호).
+    // 벽이 없거나 게임이 끝났으면 비어 있다.
+    void legalWalls(typename Board::WallMask& horizontal, typename Board::WallMask& vertical) const;
+
+    // 수 하나만 검사한다 (합법수 전체를 만들지 않는다). apply가 적용 전에 하는 검사와 같다.
+    MoveError checkMove(const Move& move) const;
+    // 수를 검사하고 적용한다. 실패하면 상태는 그대로다.
+    MoveError apply(const Move& move);
+    // 검사 없이 둔다. legalMoves가 만든 수처럼 합법이 확실한 수에만 쓴다 (탐색, perft).
+    void makeMove(const Move& move);
+    // 직전에 둔 수(apply 또는 makeMove)를 되돌린다. 폰 위치, 남은 벽, 해시, Board의 거리 맵까지
+    // 두기 전과 똑같아진다. 몇 수를 되돌리든 힙 할당은 없다.
+    void unmakeMove(const Move& move);
+
+    bool hasPlayerReachedGoal(std::size_t playerIndex) const;
+    bool isCellOccupied(const Position& position, std::size_t ignoreIndex) const;
+    bool playerHasPathToGoal(std::size_t playerIndex) const;
+    bool allPlayersHavePath() const;
+
+private:
+    MoveError resolveOrthogonalMove(const Position& current,
+                                    const Position& target,
+                                    int& destination) const;
+    MoveError resolveDiagonalMove(const Position& current,
+                                  const Position& target,
+                                  int& destination) const;
+    MoveError checkWall(const Position& position, bool horizontal) const;
+    void generatePawnMoves(MoveList& moves) const;
+    void generateWallMoves(MoveList& moves) const;
+    bool wallKeepsPaths(const Position& position, bool horizontal) const;
+    void pathTargets(Position* starts, GoalType* goals) const;
+    bool canSideStep(int from, typename Board::Direction toward, typename Board::Direction side,
+                     const CellSet& occupied) const;
+    CellSet goalMaskForPlayer(std::size_t playerIndex) const;
+    GoalType determineGoalType(const Position& startPosition) const;
+    void updateWinner();
+    std::uint64_t computeHash() const;
+    void resetHistory();
+
+    void placePawn(std::size_t playerIndex, int cell);
+
+    using Zobrist = BasicZobrist<N>;
+    static_assert(kPlayerCount <= Zobrist::kSeatCount, "every seat needs Zobrist keys");
+    static_assert(kWallsPerPlayer <= Zobrist::kMaxWalls, "every wall count needs a Zobrist key");
+
+    // 수마다 읽고 쓰는 좌석 상태를 한데 모은 것. 셀 번호는 7비트(11x11까지 121칸)라 한 바이트에 들어가고,
+    // occupied로 점유 검사는 비트 하나만 본다. 통째로 32바이트라 캐시 라인 하나에 들어간다.
+    struct Seats {
+        CellSet occupied;                   // cell[]에 있는 셀들
+        std::uint8_t cell[kPlayerCount];    // 폰 셀 번호
+        std::uint8_t walls[kPlayerCount];   // 남은 벽
+        std::uint8_t goal[kPlayerCount];    // GoalType
+        std::uint8_t turn;
+        std::int8_t winner;                 // kNoWinner면 -1
+    };
+    static_assert(sizeof(Seats) <= 64, "seat state fits in one cache line");
+
+    Board board_;
+    Seats seats_;
+    std::uint64_t hash_;
+    // 최근 수들의 두기 직전 해시 (반복 검사용 고리). historyEnd_는 지금까지 쌓은 수, historySize_는 유효한 칸 수.
+    std::array<std::uint64_t, kHistoryCapacity> history_;
+    std::uint32_t historyEnd_;
+    std::uint32_t historySize_;
+};
+
+using GameState = BasicGameState<9>;
+
+#endif  // GAMESTATE_HPP
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 읽기 전용 메모리 매핑 파일. 여는 비용은 파일 크기와 상관없고,
+// 실제로 건드린 페이지만 운영체제가 읽어 들인다.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened_; }
+    const std::uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    bool opened_;  // 빈 파일은 매핑하지 않지만 열린 것으로 친다
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+};
+
+#endif  // MAPPEDFILE_HPP
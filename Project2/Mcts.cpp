@@ -0,0 +1,316 @@
+#include "Mcts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Notation.h"
+
+namespace {
+// 보상 단위: 승 4, 무 1, 패 0
+constexpr std::int64_t kRewardScale = 4;
+constexpr std::int64_t kDrawReward = 1;
+
+constexpr double kExploration = 1.0;
+// 아직 안 가 본 자식은 한 번 가 본 자식처럼 탐험 항을 주되, 값은 형제 평균보다
+// 이만큼 낮게 본다 (first play urgency)
+constexpr double kFirstPlayReduction = 0.1;
+// 방문이 이만큼 쌓인 잎만 펼친다 (벽 때문에 자식이 100개를 넘어서)
+constexpr std::int32_t kExpandVisits = 2;
+
+// 롤아웃: 이 확률로 최단 거리 쪽 폰 이동, 나머지는 무작위 폰 이동
+constexpr double kGreedyProbability = 0.8;
+constexpr int kMaxRolloutPlies = 200;
+constexpr int kMaxTreeDepth = 256;
+
+std::int64_t rewardFor(int winner, std::size_t seat) {
+    if (winner == GameState::kNoWinner) {
+        return kDrawReward;
+    }
+    return static_cast<std::size_t>(winner) == seat ? kRewardScale : 0;
+}
+
+// 이 폰 이동 뒤 둔 사람의 셀 (자리바꾸기면 상대 자리로 간다)
+int landingCell(const GameState& state, const Move& move) {
+    if (move.isSwap()) {
+        return state.pawnCell(move.swapWith);
+    }
+    return move.to;
+}
+
+int distanceAfter(const GameState& state, const Move& move) {
+    return state.board().distanceToGoal(Board::cellPosition(landingCell(state, move)),
+                                        state.goalOf(state.currentTurn()));
+}
+}  // namespace
+
+constexpr std::uint64_t MctsSearch::kDefaultPlayouts;
+
+MctsSearch::MctsSearch(std::size_t megabytes)
+    : capacity_(std::max<std::size_t>(megabytes, 1) * 1024 * 1024 / sizeof(Node)),
+      nodeCount_(0), stop_(false), playouts_(0), maxDepth_(0) {
+}
+
+SearchResult MctsSearch::search(const GameState& state, const SearchLimits& limits) {
+    const auto start = std::chrono::steady_clock::now();
+    if (!nodes_) {
+        nodes_.reset(new Node[capacity_]);
+    }
+
+    limits_ = limits;
+    if (limits_.timeMillis <= 0 && limits_.maxNodes == 0) {
+        limits_.maxNodes = kDefaultPlayouts;
+    }
+    deadline_ = start + std::chrono::milliseconds(limits_.timeMillis);
+
+    EndgameSolver::Result solved;
+    if (endgame_.solve(state, solved, EndgameSolver::Budget::forMove(limits_.timeMillis, limits_.maxNodes))) {
+        SearchResult result;
+        result.bestMove = solved.move;
+        result.hasMove = true;
+        result.score = 1000;
+        result.depth = solved.plies;
+        result.nodes = solved.nodes;
+        result.seconds = solved.seconds;
+        return result;
+    }
+
+    stop_.store(false);
+    playouts_.store(0);
+    maxDepth_.store(0);
+
+    nodeCount_.store(1);
+    Node& root = nodes_[0];
+    initializeNode(root, Move(), state.currentTurn());
+    expand(root, state);
+
+    SearchResult result;
+    if (root.state.load() != kExpanded || root.childCount == 0) {
+        return result;
+    }
+
+    const int threadCount = std::max(1, limits_.threads);
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i) {
+        helpers.emplace_back([this, &state, i]() { runWorker(state, static_cast<std::uint64_t>(i)); });
+    }
+    runWorker(state, 0);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // 가장 많이 방문한 수
+    const Node* best = &nodes_[root.firstChild];
+    for (std::uint32_t i = 1; i < root.childCount; ++i) {
+        const Node& child = nodes_[root.firstChild + i];
+        if (child.visits.load() > best->visits.load()) {
+            best = &child;
+        }
+    }
+
+    result.bestMove = best->move;
+    result.hasMove = true;
+    const std::int32_t visits = std::max(best->visits.load(), 1);
+    result.score = static_cast<int>(1000 * best->reward.load() / (kRewardScale * visits));
+    result.depth = maxDepth_.load();
+    result.nodes = playouts_.load();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void MctsSearch::runWorker(const GameState& root, std::uint64_t seed) {
+    std::mt19937_64 random(0x2545F4914F6CDD1DULL + seed);
+    // GameState 복사는 힙 할당 없는 memcpy다 (해시 기록도 고정 크기)
+    GameState scratch = root;
+    int path[kMaxTreeDepth + 1];
+
+    while (!shouldStop()) {
+        scratch = root;
+        Node* node = &nodes_[0];
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        int depth = 0;
+
+        // 선택: 펼쳐진 노드를 따라 내려가며 방문 수를 먼저 올린다 (가상 패배)
+        while (!scratch.isGameOver() && depth < kMaxTreeDepth) {
+            std::uint8_t nodeState = node->state.load(std::memory_order_acquire);
+            if (nodeState == kLeaf &&
+                node->visits.load(std::memory_order_relaxed) > kExpandVisits &&
+                node->state.compare_exchange_strong(nodeState, kExpanding)) {
+                expand(*node, scratch);
+                nodeState = node->state.load(std::memory_order_acquire);
+            }
+            if (nodeState != kExpanded || node->childCount == 0) {
+                break;
+            }
+
+            const int child = selectChild(*node);
+            node = &nodes_[child];
+            node->visits.fetch_add(1, std::memory_order_relaxed);
+            scratch.makeMove(node->move);
+            path[++depth] = child;
+        }
+
+        const int winner = scratch.isGameOver() ? scratch.winner() : rollout(scratch, random);
+        for (int i = 1; i <= depth; ++i) {
+            Node& visited = nodes_[path[i]];
+            visited.reward.fetch_add(rewardFor(winner, visited.seat), std::memory_order_relaxed);
+        }
+
+        int deepest = maxDepth_.load(std::memory_order_relaxed);
+        while (depth > deepest &&
+               !maxDepth_.compare_exchange_weak(deepest, depth, std::memory_order_relaxed)) {
+        }
+        playouts_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int MctsSearch::selectChild(const Node& node) const {
+    // 형제 평균 보상 (first play urgency 기준)
+    std::int64_t rewardSum = 0;
+    std::int64_t visitSum = 0;
+    for (std::uint32_t i = 0; i < node.childCount; ++i) {
+        const Node& child = nodes_[node.firstChild + i];
+        rewardSum += child.reward.load(std::memory_order_relaxed);
+        visitSum += child.visits.load(std::memory_order_relaxed);
+    }
+    const double mean = visitSum > 0 ? static_cast<double>(rewardSum) / (kRewardScale * visitSum) : 0.5;
+    const double logParent = std::log(static_cast<double>(std::max<std::int64_t>(visitSum, 1)));
+    const double firstPlay = std::max(0.0, mean - kFirstPlayReduction) + kExploration * std::sqrt(logParent);
+
+    int best = static_cast<int>(node.firstChild);
+    double bestScore = -1;
+    for (std::uint32_t i = 0; i < node.childCount; ++i) {
+        const Node& child = nodes_[node.firstChild + i];
+        const std::int32_t visits = child.visits.load(std::memory_order_relaxed);
+        double score;
+        if (visits == 0) {
+            score = firstPlay;
+        } else {
+            const double value = static_cast<double>(child.reward.load(std::memory_order_relaxed)) /
+                                 (kRewardScale * visits);
+            score = value + kExploration * std::sqrt(logParent / visits);
+        }
+        // 같은 점수면 앞쪽(정렬상 더 좋아 보이는) 자식
+        if (score > bestScore) {
+            bestScore = score;
+            best = static_cast<int>(node.firstChild + i);
+        }
+    }
+    return best;
+}
+
+void MctsSearch::expand(Node& node, const GameState& state) {
+    MoveList moves;
+    state.legalMoves(moves);
+    const std::size_t count = static_cast<std::size_t>(moves.size());
+    if (count == 0 || nodeCount_.load(std::memory_order_relaxed) + count > capacity_) {
+        // 둘 수가 없거나 풀이 찼다: 잎으로 남겨 롤아웃만 한다
+        node.childCount = 0;
+        node.state.store(kExpanded, std::memory_order_release);
+        return;
+    }
+    const std::size_t first = nodeCount_.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > capacity_) {
+        node.childCount = 0;
+        node.state.store(kExpanded, std::memory_order_release);
+        return;
+    }
+
+    // 거리를 줄이는 폰 이동을 앞에 둔다 (안 가 본 자식끼리는 앞쪽이 먼저 뽑힌다)
+    const GoalType goal = state.goalOf(state.currentTurn());
+    const int current = state.board().distanceToGoal(state.pawnCell(state.currentTurn()), goal);
+    std::stable_sort(moves.begin(), moves.end(), [&](const Move& a, const Move& b) {
+        const int gainA = a.isWall() ? 0 : current - distanceAfter(state, a);
+        const int gainB = b.isWall() ? 0 : current - distanceAfter(state, b);
+        return gainA > gainB;
+    });
+
+    for (std::size_t i = 0; i < count; ++i) {
+        initializeNode(nodes_[first + i], moves[static_cast<int>(i)], state.currentTurn());
+    }
+    node.firstChild = static_cast<std::uint32_t>(first);
+    node.childCount = static_cast<std::uint16_t>(count);
+    node.state.store(kExpanded, std::memory_order_release);
+}
+
+int MctsSearch::rollout(GameState& state, std::mt19937_64& random) const {
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    MoveList moves;
+    for (int ply = 0; ply < kMaxRolloutPlies && !state.isGameOver(); ++ply) {
+        state.legalPawnMoves(moves);
+        if (moves.empty()) {
+            return GameState::kNoWinner;
+        }
+
+        int chosen = static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()));
+        if (chance(random) < kGreedyProbability) {
+            int bestDistance = Board::kUnreachable + 1;
+            int ties = 0;
+            for (int i = 0; i < moves.size(); ++i) {
+                const int distance = distanceAfter(state, moves[i]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    chosen = i;
+                    ties = 1;
+                } else if (distance == bestDistance && random() % ++ties == 0) {
+                    chosen = i;
+                }
+            }
+        }
+        state.makeMove(moves[chosen]);
+    }
+    return state.winner();
+}
+
+bool MctsSearch::shouldStop() const {
+    if (stop_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (limits_.maxNodes > 0 && playouts_.load(std::memory_order_relaxed) >= limits_.maxNodes) {
+        return true;
+    }
+    return limits_.timeMillis > 0 && std::chrono::steady_clock::now() >= deadline_;
+}
+
+void MctsSearch::initializeNode(Node& node, const Move& move, std::size_t seat) {
+    node.move = move;
+    node.seat = static_cast<std::uint8_t>(seat);
+    node.state.store(kLeaf, std::memory_order_relaxed);
+    node.childCount = 0;
+    node.firstChild = 0;
+    node.visits.store(0, std::memory_order_relaxed);
+    node.reward.store(0, std::memory_order_relaxed);
+}
+
+int runMctsBenchCommand(int argc, char** argv) {
+    SearchLimits limits;
+    int maxThreads = 64;
+    if (argc > 0) limits.timeMillis = std::atoi(argv[0]);
+    if (argc > 1) maxThreads = std::atoi(argv[1]);
+    if (limits.timeMillis <= 0 || maxThreads <= 0) {
+        std::cout << "usage: project2 mcts-bench [milliseconds [max threads]]\n";
+        return 1;
+    }
+
+    GameState state;
+    MctsSearch search;
+    double singleRate = 0;
+    std::cout << "hardware threads " << std::thread::hardware_concurrency() << '\n';
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        limits.threads = threads;
+        const SearchResult result = search.search(state, limits);
+        const double rate = result.nodes / std::max(result.seconds, 1e-9);
+        if (threads == 1) {
+            singleRate = rate;
+        }
+        std::cout << threads << " threads: " << result.nodes << " playouts, "
+                  << static_cast<std::uint64_t>(rate) << " playouts/s, x"
+                  << (singleRate > 0 ? rate / singleRate : 0) << ", best "
+                  << notation::moveName(result.bestMove) << " (" << result.score
+                  << "/1000), depth " << result.depth << '\n';
+    }
+    return 0;
+}
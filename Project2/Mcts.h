@@ -0,0 +1,77 @@
+#pragma once
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "Endgame.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Search.h"
+
+// UCT 몬테카를로 트리 탐색. 여러 스레드가 트리 하나를 공유하고,
+// 내려가면서 방문 수를 먼저 올려 두는 가상 패배(virtual loss)로 서로 다른 가지를 고르게 한다.
+//
+// 보상은 좌석마다 따로 본다 (4인 비제로섬): 노드에는 그 노드로 들어오는 수를 둔 좌석의
+// 보상만 쌓는다. 롤아웃은 벽 없이 폰만 움직이며, 대부분 최단 거리 쪽으로 간다.
+//
+// SearchLimits는 alpha-beta와 같이 쓴다: maxNodes는 플레이아웃 수, maxDepth는 쓰지 않는다.
+// 시간과 플레이아웃 제한이 둘 다 없으면 kDefaultPlayouts번 돈다.
+// SearchResult.nodes는 플레이아웃 수, depth는 트리 최대 깊이, score는 승률(천분율).
+// 벽이 모두 떨어진 국면에서 EndgameSolver가 강제 승리를 찾으면 트리를 만들지 않고 그 수를 낸다
+// (이때 nodes는 풀이기 노드 수, depth는 도착까지 수, score는 1000).
+class MctsSearch {
+public:
+    static constexpr std::uint64_t kDefaultPlayouts = 2000;
+
+    // 트리 노드 풀 크기. 첫 탐색 때 한 번 잡는다.
+    explicit MctsSearch(std::size_t megabytes = 64);
+
+    SearchResult search(const GameState& state, const SearchLimits& limits);
+
+private:
+    enum NodeState : std::uint8_t {
+        kLeaf,
+        kExpanding,
+        kExpanded
+    };
+
+    struct Node {
+        Move move;                          // 부모에서 이 노드로 온 수
+        std::uint8_t seat;                  // 그 수를 둔 좌석 (reward 기준)
+        std::atomic<std::uint8_t> state;
+        std::uint16_t childCount;
+        std::uint32_t firstChild;
+        std::atomic<std::int32_t> visits;   // 진행 중인 플레이아웃(가상 패배) 포함
+        std::atomic<std::int64_t> reward;   // seat 기준 보상, kRewardScale 단위
+    };
+
+    void runWorker(const GameState& root, std::uint64_t seed);
+    int selectChild(const Node& node) const;
+    void expand(Node& node, const GameState& state);
+    int rollout(GameState& state, std::mt19937_64& random) const;
+    bool shouldStop() const;
+    void initializeNode(Node& node, const Move& move, std::size_t seat);
+
+    std::unique_ptr<Node[]> nodes_;
+    std::size_t capacity_;
+    EndgameSolver endgame_;
+    std::atomic<std::size_t> nodeCount_;
+
+    SearchLimits limits_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<bool> stop_;
+    std::atomic<std::uint64_t> playouts_;
+    std::atomic<int> maxDepth_;
+};
+
+// "project2 mcts-bench [ms [max threads]]" 명령. 시작 국면에서 스레드 수를 1, 2, 4, ...로
+// 늘려 가며 플레이아웃/초와 1스레드 대비 배율을 출력한다.
+int runMctsBenchCommand(int argc, char** argv);
+
+#endif  // MCTS_HPP
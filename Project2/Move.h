@@ -0,0 +1,82 @@
+#pragma once
+#ifndef MOVE_HPP
+#define MOVE_HPP
+
+#include <cstdint>
+
+// 한 턴의 수. 폰 이동(한 칸, 점프, 대각선)과 벽 놓기 두 종류가 있다.
+// 셀과 벽 슬롯은 Board::cellIndex / Board::wallSlot 번호를 쓴다.
+struct Move {
+    enum class Type : std::uint8_t {
+        Pawn,
+        Wall
+    };
+
+    static constexpr std::uint8_t kNoSwap = 0xFF;
+
+    Type type = Type::Pawn;
+    std::uint8_t from = 0;            // 폰: 출발 셀
+    std::uint8_t to = 0;              // 폰: 도착 셀, 벽: 슬롯 번호
+    std::uint8_t swapWith = kNoSwap;  // 빨간 칸에 도착했을 때 자리를 바꿀 좌석
+
+    static Move pawn(int from, int to, int swapWith = kNoSwap) {
+        Move move;
+        move.type = Type::Pawn;
+        move.from = static_cast<std::uint8_t>(from);
+        move.to = static_cast<std::uint8_t>(to);
+        move.swapWith = static_cast<std::uint8_t>(swapWith);
+        return move;
+    }
+
+    static Move wall(int slot) {
+        Move move;
+        move.type = Type::Wall;
+        move.to = static_cast<std::uint8_t>(slot);
+        return move;
+    }
+
+    bool isWall() const { return type == Type::Wall; }
+    bool isSwap() const { return type == Type::Pawn && swapWith != kNoSwap; }
+    int wallSlot() const { return to; }
+};
+
+inline bool operator==(const Move& a, const Move& b) {
+    return a.type == b.type && a.from == b.from && a.to == b.to && a.swapWith == b.swapWith;
+}
+
+inline bool operator!=(const Move& a, const Move& b) {
+    return !(a == b);
+}
+
+// 스택에 잡히는 고정 크기 수 목록. 힙 할당 없이 한 국면의 모든 합법수를 담는다.
+// 크기는 보드 크기마다 다르다 (BasicGameState<N>::MoveList).
+template <int Capacity>
+class BasicMoveList {
+public:
+    static constexpr int kCapacity = Capacity;
+
+    BasicMoveList() : size_(0) {}
+
+    void clear() { size_ = 0; }
+    void push(const Move& move) { moves_[size_++] = move; }
+
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Move& operator[](int index) const { return moves_[index]; }
+    Move& operator[](int index) { return moves_[index]; }
+
+    const Move* begin() const { return moves_; }
+    const Move* end() const { return moves_ + size_; }
+    Move* begin() { return moves_; }
+    Move* end() { return moves_ + size_; }
+
+private:
+    Move moves_[Capacity];
+    int size_;
+};
+
+// 9x9: 폰 도착 셀은 최대 8곳이고 빨간 칸이면 자리바꾸기 3가지가 더 붙는다 (8 * 4),
+// 여기에 벽 슬롯 128개.
+using MoveList = BasicMoveList<8 * 4 + 128>;
+
+#endif  // MOVE_HPP
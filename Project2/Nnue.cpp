@@ -0,0 +1,813 @@
+#include "Nnue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include "GameRecord.h"
+#include "MappedFile.h"
+#include "Search.h"
+#include "Simd.h"
+
+namespace {
+constexpr char kMagic[8] = {'Q', 'N', 'N', 'U', 'E', '0', '0', '1'};
+
+// 양자화 배율. 활성값 1.0이 127, 뒤쪽 층 가중치 1.0이 64다.
+constexpr int kActivationMax = 127;
+constexpr int kWeightScale = 64;
+constexpr int kHiddenShift = 6;  // log2(kWeightScale)
+constexpr int kMaxScore = 30000;
+
+constexpr int kWallBase = nnue::kPawnFeatures;
+constexpr int kWallCountBase = kWallBase + nnue::kWallFeatures;
+constexpr int kTurnBase = kWallCountBase + nnue::kWallCountFeatures;
+
+struct Header {
+    char magic[8];
+    std::uint32_t features;
+    std::uint32_t hidden;
+    std::uint32_t hidden2;
+    std::uint32_t reserved;
+};
+
+// 관점 좌석의 목표가 0행이 되도록 돌린 셀 번호와 벽 슬롯 번호 (GoalType 순서)
+struct Orientation {
+    std::uint8_t cell[Board::kGoalCount][Board::kCellCount];
+    std::uint8_t wall[Board::kGoalCount][Board::kWallSlotCount];
+
+    Orientation() {
+        const int last = Board::kSize - 1;
+        const int wallLast = Board::kWallGrid - 1;
+        for (int goal = 0; goal < Board::kGoalCount; ++goal) {
+            for (int cell = 0; cell < Board::kCellCount; ++cell) {
+                const Position p = Board::cellPosition(cell);
+                int row = p.row;
+                int col = p.col;
+                switch (static_cast<GoalType>(goal)) {
+                    case GoalType::Row0: break;
+                    case GoalType::RowLast: row = last - p.row; col = last - p.col; break;
+                    case GoalType::Col0: row = p.col; col = last - p.row; break;
+                    case GoalType::ColLast: row = last - p.col; col = p.row; break;
+                }
+                this->cell[goal][cell] = static_cast<std::uint8_t>(Board::cellIndex(row, col));
+            }
+            // 벽은 네 셀 사이의 꼭짓점에 놓이므로 같은 회전을 (kSize - 1) 격자에 하고, 90도 돌리면 방향이 바뀐다
+            for (int slot = 0; slot < Board::kWallSlotCount; ++slot) {
+                const Position p = Board::wallSlotPosition(slot);
+                bool horizontal = Board::isHorizontalSlot(slot);
+                Position q = p;
+                switch (static_cast<GoalType>(goal)) {
+                    case GoalType::Row0: break;
+                    case GoalType::RowLast: q.row = wallLast - p.row; q.col = wallLast - p.col; break;
+                    case GoalType::Col0: q.row = p.col; q.col = wallLast - p.row; horizontal = !horizontal; break;
+                    case GoalType::ColLast: q.row = wallLast - p.col; q.col = p.row; horizontal = !horizontal; break;
+                }
+                wall[goal][slot] = static_cast<std::uint8_t>(Board::wallSlot(q, horizontal));
+            }
+        }
+    }
+};
+
+const Orientation& orientation() {
+    static const Orientation table;
+    return table;
+}
+
+int relativeSeat(std::size_t seat, std::size_t perspective) {
+    return static_cast<int>((seat + GameState::kPlayerCount - perspective) % GameState::kPlayerCount);
+}
+
+int pawnFeature(int goal, int relative, int cell) {
+    return relative * Board::kCellCount + orientation().cell[goal][cell];
+}
+
+int wallFeature(int goal, int slot) {
+    return kWallBase + orientation().wall[goal][slot];
+}
+
+int wallCountFeature(int relative, int count) {
+    return kWallCountBase + relative * (GameState::kWallsPerPlayer + 1) +
+           std::min(count, GameState::kWallsPerPlayer);
+}
+
+int turnFeature(int relative) {
+    return kTurnBase + relative;
+}
+
+// 커널. 누산기 갱신은 removed 행을 빼고 added 행을 더한다.
+// 순전파는 누산기에서 출력층 int32 합까지 (점수 환산은 Network::evaluate가 한다).
+using UpdateKernel = void (*)(std::int16_t* values, const std::int16_t* const* removed, int removedCount,
+                              const std::int16_t* const* added, int addedCount);
+using ForwardKernel = std::int32_t (*)(const std::int16_t* values, const std::int8_t* hiddenWeights,
+                                       const std::int32_t* hiddenBias, const std::int8_t* outputWeights,
+                                       std::int32_t outputBias);
+
+struct Kernels {
+    UpdateKernel update;
+    ForwardKernel forward;
+    const char* name;
+};
+
+void updateScalar(std::int16_t* values, const std::int16_t* const* removed, int removedCount,
+                  const std::int16_t* const* added, int addedCount) {
+    for (int i = 0; i < nnue::kHidden; ++i) {
+        int value = values[i];
+        for (int r = 0; r < removedCount; ++r) value -= removed[r][i];
+        for (int a = 0; a < addedCount; ++a) value += added[a][i];
+        // AVX2 경로처럼 16비트로 감싼다
+        values[i] = static_cast<std::int16_t>(value);
+    }
+}
+
+std::int32_t outputLayer(const std::int32_t* hidden, const std::int8_t* outputWeights, std::int32_t outputBias) {
+    std::int32_t sum = outputBias;
+    for (int o = 0; o < nnue::kHidden2; ++o) {
+        sum += hidden[o] * outputWeights[o];
+    }
+    return sum;
+}
+
+std::int32_t forwardScalar(const std::int16_t* values, const std::int8_t* hiddenWeights,
+                           const std::int32_t* hiddenBias, const std::int8_t* outputWeights,
+                           std::int32_t outputBias) {
+    std::uint8_t input[nnue::kHidden];
+    for (int i = 0; i < nnue::kHidden; ++i) {
+        input[i] = static_cast<std::uint8_t>(std::min<int>(std::max<int>(values[i], 0), kActivationMax));
+    }
+    std::int32_t hidden[nnue::kHidden2];
+    for (int o = 0; o < nnue::kHidden2; ++o) {
+        const std::int8_t* row = hiddenWeights + o * nnue::kHidden;
+        std::int32_t sum = hiddenBias[o];
+        for (int i = 0; i < nnue::kHidden; ++i) {
+            sum += input[i] * row[i];
+        }
+        hidden[o] = std::min(std::max(sum, 0) >> kHiddenShift, kActivationMax);
+    }
+    return outputLayer(hidden, outputWeights, outputBias);
+}
+
+#ifdef SIMD_X86
+constexpr int kInt16Registers = nnue::kHidden / 16;
+constexpr int kInt8Registers = nnue::kHidden / 32;
+
+SIMD_AVX2 void updateAvx2(std::int16_t* values, const std::int16_t* const* removed, int removedCount,
+                          const std::int16_t* const* added, int addedCount) {
+    // 누산기 전체(128 x int16)가 레지스터 8개에 들어간다
+    __m256i sums[kInt16Registers];
+    for (int k = 0; k < kInt16Registers; ++k) {
+        sums[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 16 * k));
+    }
+    for (int r = 0; r < removedCount; ++r) {
+        for (int k = 0; k < kInt16Registers; ++k) {
+            sums[k] = _mm256_sub_epi16(sums[k], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed[r] + 16 * k)));
+        }
+    }
+    for (int a = 0; a < addedCount; ++a) {
+        for (int k = 0; k < kInt16Registers; ++k) {
+            sums[k] = _mm256_add_epi16(sums[k], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added[a] + 16 * k)));
+        }
+    }
+    for (int k = 0; k < kInt16Registers; ++k) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + 16 * k), sums[k]);
+    }
+}
+
+// 행 하나의 uint8 x int8 내적을 int32 8개로 (maddubs의 16비트 합은 127 x 128 x 2 < 32768이라 포화하지 않는다)
+SIMD_AVX2 inline __m256i dotRow(const __m256i* input, const std::int8_t* row, __m256i ones) {
+    __m256i sum = _mm256_setzero_si256();
+    for (int k = 0; k < kInt8Registers; ++k) {
+        const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 32 * k));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(input[k], weights), ones));
+    }
+    return sum;
+}
+
+SIMD_AVX2 std::int32_t forwardAvx2(const std::int16_t* values, const std::int8_t* hiddenWeights,
+                                   const std::int32_t* hiddenBias, const std::int8_t* outputWeights,
+                                   std::int32_t outputBias) {
+    // clipped ReLU: 127로 자르고 uint8로 포화 압축 (음수는 0). packus가 128비트 반쪽끼리 섞으므로 순서를 되돌린다.
+    const __m256i activationMax = _mm256_set1_epi16(kActivationMax);
+    __m256i input[kInt8Registers];
+    for (int k = 0; k < kInt8Registers; ++k) {
+        const __m256i low = _mm256_min_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 32 * k)), activationMax);
+        const __m256i high = _mm256_min_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 32 * k + 16)), activationMax);
+        input[k] = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+    }
+
+    // 출력 4개씩: 행마다 int32 8개를 hadd 두 번과 반쪽 더하기로 하나씩 줄인다
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i hiddenMax = _mm_set1_epi32(kActivationMax);
+    alignas(16) std::int32_t hidden[nnue::kHidden2];
+    for (int o = 0; o < nnue::kHidden2; o += 4) {
+        const std::int8_t* rows = hiddenWeights + o * nnue::kHidden;
+        const __m256i r0 = dotRow(input, rows, ones);
+        const __m256i r1 = dotRow(input, rows + nnue::kHidden, ones);
+        const __m256i r2 = dotRow(input, rows + 2 * nnue::kHidden, ones);
+        const __m256i r3 = dotRow(input, rows + 3 * nnue::kHidden, ones);
+        const __m256i quad = _mm256_hadd_epi32(_mm256_hadd_epi32(r0, r1), _mm256_hadd_epi32(r2, r3));
+        __m128i sums = _mm_add_epi32(_mm256_castsi256_si128(quad), _mm256_extracti128_si256(quad, 1));
+        sums = _mm_add_epi32(sums, _mm_loadu_si128(reinterpret_cast<const __m128i*>(hiddenBias + o)));
+        sums = _mm_min_epi32(_mm_srai_epi32(_mm_max_epi32(sums, zero), kHiddenShift), hiddenMax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(hidden + o), sums);
+    }
+    return outputLayer(hidden, outputWeights, outputBias);
+}
+#endif  // SIMD_X86
+
+Kernels selectKernels() {
+#ifdef SIMD_X86
+    if (cpuHasAvx2()) {
+        return Kernels{updateAvx2, forwardAvx2, "avx2"};
+    }
+#endif
+    return Kernels{updateScalar, forwardScalar, "scalar"};
+}
+
+const Kernels& activeKernels() {
+    static const Kernels kernels = selectKernels();
+    return kernels;
+}
+
+int toScore(std::int32_t output) {
+    const std::int64_t score = static_cast<std::int64_t>(output) * nnue::kScoreScale /
+                               (kActivationMax * kWeightScale);
+    return static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(score, -kMaxScore), kMaxScore));
+}
+
+// 학습용 float 망. 층 구조와 clipped ReLU는 양자화된 망과 같다.
+struct FloatNetwork {
+    std::vector<float> featureWeights;
+    std::vector<float> featureBias;
+    std::vector<float> hiddenWeights;
+    std::vector<float> hiddenBias;
+    std::vector<float> outputWeights;
+    float outputBias = 0;
+};
+
+// 한 표본 (켜진 특징 목록은 Samples::features의 [begin, end))
+struct Samples {
+    std::vector<std::uint16_t> features;
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<float> targets;
+};
+
+float clampUnit(float value) {
+    return std::min(std::max(value, 0.0f), 1.0f);
+}
+
+// 표본 하나로 순전파, 역전파, SGD까지. 교차 엔트로피 손실을 돌려준다.
+double trainSample(FloatNetwork& net, const std::uint16_t* features, int count, float target, float rate) {
+    using nnue::kHidden;
+    using nnue::kHidden2;
+    // 뒤쪽 층 가중치는 int8로 양자화될 수 있는 범위로 묶어 둔다
+    const float weightLimit = 127.0f / kWeightScale;
+
+    float z1[kHidden];
+    float a1[kHidden];
+    std::copy(net.featureBias.begin(), net.featureBias.end(), z1);
+    for (int f = 0; f < count; ++f) {
+        const float* row = &net.featureWeights[static_cast<std::size_t>(features[f]) * kHidden];
+        for (int i = 0; i < kHidden; ++i) z1[i] += row[i];
+    }
+    for (int i = 0; i < kHidden; ++i) a1[i] = clampUnit(z1[i]);
+
+    float z2[kHidden2];
+    float a2[kHidden2];
+    float logit = net.outputBias;
+    for (int o = 0; o < kHidden2; ++o) {
+        const float* row = &net.hiddenWeights[static_cast<std::size_t>(o) * kHidden];
+        float sum = net.hiddenBias[o];
+        for (int i = 0; i < kHidden; ++i) sum += row[i] * a1[i];
+        z2[o] = sum;
+        a2[o] = clampUnit(sum);
+        logit += net.outputWeights[o] * a2[o];
+    }
+
+    const float probability = 1.0f / (1.0f + std::exp(-logit));
+    const float epsilon = 1e-6f;
+    const double loss = -(target * std::log(probability + epsilon) +
+                          (1.0f - target) * std::log(1.0f - probability + epsilon));
+
+    // 시그모이드 + 교차 엔트로피의 로짓 기울기
+    const float gradLogit = probability - target;
+    float gradZ2[kHidden2];
+    for (int o = 0; o < kHidden2; ++o) {
+        gradZ2[o] = z2[o] > 0.0f && z2[o] < 1.0f ? gradLogit * net.outputWeights[o] : 0.0f;
+        net.outputWeights[o] = std::min(std::max(net.outputWeights[o] - rate * gradLogit * a2[o], -weightLimit),
+                                        weightLimit);
+    }
+    net.outputBias -= rate * gradLogit;
+
+    float gradA1[kHidden] = {};
+    for (int o = 0; o < kHidden2; ++o) {
+        if (gradZ2[o] == 0.0f) continue;
+        float* row = &net.hiddenWeights[static_cast<std::size_t>(o) * kHidden];
+        for (int i = 0; i < kHidden; ++i) {
+            gradA1[i] += gradZ2[o] * row[i];
+            row[i] = std::min(std::max(row[i] - rate * gradZ2[o] * a1[i], -weightLimit), weightLimit);
+        }
+        net.hiddenBias[o] -= rate * gradZ2[o];
+    }
+
+    for (int i = 0; i < kHidden; ++i) {
+        if (!(z1[i] > 0.0f && z1[i] < 1.0f)) gradA1[i] = 0.0f;
+        net.featureBias[i] -= rate * gradA1[i];
+    }
+    for (int f = 0; f < count; ++f) {
+        float* row = &net.featureWeights[static_cast<std::size_t>(features[f]) * kHidden];
+        for (int i = 0; i < kHidden; ++i) row[i] -= rate * gradA1[i];
+    }
+    return loss;
+}
+
+template <typename T>
+T quantize(float value, float scale, T low, T high) {
+    const float scaled = std::round(value * scale);
+    return static_cast<T>(std::min(std::max(scaled, static_cast<float>(low)), static_cast<float>(high)));
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 잰 반복이 최적화로 사라지지 않게 결과를 여기에 쓴다
+volatile long long benchSink;
+
+void printUsage() {
+    std::cout << "usage: project2 nnue train <out> [--epochs n] [--rate r] <record files...>\n"
+              << "       project2 nnue bench [network]\n";
+}
+}  // namespace
+
+namespace nnue {
+
+int activeFeatures(const GameState& state, std::size_t seat, int* features) {
+    const int goal = static_cast<int>(state.goalOf(seat));
+    int count = 0;
+    for (std::size_t other = 0; other < GameState::kPlayerCount; ++other) {
+        const int relative = relativeSeat(other, seat);
+        features[count++] = pawnFeature(goal, relative, state.pawnCell(other));
+        features[count++] = wallCountFeature(relative, state.wallsRemaining(other));
+    }
+    for (int slot = 0; slot < Board::kWallSlotCount; ++slot) {
+        if (state.board().hasWall(Board::wallSlotPosition(slot), Board::isHorizontalSlot(slot))) {
+            features[count++] = wallFeature(goal, slot);
+        }
+    }
+    features[count++] = turnFeature(relativeSeat(state.currentTurn(), seat));
+    return count;
+}
+
+void changedFeatures(const GameState& state, const Move& move, std::size_t seat,
+                     int* removed, int& removedCount, int* added, int& addedCount) {
+    const int goal = static_cast<int>(state.goalOf(seat));
+    const std::size_t mover = state.currentTurn();
+    const int relative = relativeSeat(mover, seat);
+    removedCount = 0;
+    addedCount = 0;
+
+    bool wins = false;
+    if (move.isWall()) {
+        const int walls = state.wallsRemaining(mover);
+        added[addedCount++] = wallFeature(goal, move.wallSlot());
+        removed[removedCount++] = wallCountFeature(relative, walls);
+        added[addedCount++] = wallCountFeature(relative, walls - 1);
+    } else {
+        const int landing = move.isSwap() ? state.pawnCell(move.swapWith) : move.to;
+        removed[removedCount++] = pawnFeature(goal, relative, state.pawnCell(mover));
+        added[addedCount++] = pawnFeature(goal, relative, landing);
+        if (move.isSwap()) {
+            const int other = relativeSeat(move.swapWith, seat);
+            removed[removedCount++] = pawnFeature(goal, other, state.pawnCell(move.swapWith));
+            added[addedCount++] = pawnFeature(goal, other, move.to);
+        }
+        // 도착한 수는 차례를 넘기지 않는다 (자리를 바꾼 상대는 빨간 칸으로 가므로 도착하지 않는다)
+        wins = Board::isGoalCell(landing, state.goalOf(mover));
+    }
+    if (!wins) {
+        removed[removedCount++] = turnFeature(relative);
+        added[addedCount++] = turnFeature(relativeSeat((mover + 1) % GameState::kPlayerCount, seat));
+    }
+}
+
+Network::Network()
+    : featureWeights_(static_cast<std::size_t>(kFeatureCount) * kHidden),
+      featureBias_(kHidden),
+      hiddenWeights_(static_cast<std::size_t>(kHidden2) * kHidden),
+      hiddenBias_(kHidden2),
+      outputWeights_(kHidden2),
+      outputBias_(0) {
+}
+
+bool Network::load(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const std::size_t expected = sizeof(Header) + featureWeights_.size() * sizeof(std::int16_t) +
+                                 featureBias_.size() * sizeof(std::int16_t) + hiddenWeights_.size() +
+                                 hiddenBias_.size() * sizeof(std::int32_t) + outputWeights_.size() +
+                                 sizeof(std::int32_t);
+    Header header;
+    if (file.size() != expected) {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.features != kFeatureCount ||
+        header.hidden != kHidden || header.hidden2 != kHidden2) {
+        return false;
+    }
+
+    const std::uint8_t* data = file.data() + sizeof(Header);
+    auto read = [&data](void* out, std::size_t bytes) {
+        std::memcpy(out, data, bytes);
+        data += bytes;
+    };
+    read(featureWeights_.data(), featureWeights_.size() * sizeof(std::int16_t));
+    read(featureBias_.data(), featureBias_.size() * sizeof(std::int16_t));
+    read(hiddenWeights_.data(), hiddenWeights_.size());
+    read(hiddenBias_.data(), hiddenBias_.size() * sizeof(std::int32_t));
+    read(outputWeights_.data(), outputWeights_.size());
+    read(&outputBias_, sizeof(outputBias_));
+    return true;
+}
+
+bool Network::save(const std::string& path) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.features = kFeatureCount;
+    header.hidden = kHidden;
+    header.hidden2 = kHidden2;
+    header.reserved = 0;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    ok = ok && std::fwrite(featureWeights_.data(), sizeof(std::int16_t), featureWeights_.size(), out) ==
+                   featureWeights_.size();
+    ok = ok && std::fwrite(featureBias_.data(), sizeof(std::int16_t), featureBias_.size(), out) ==
+                   featureBias_.size();
+    ok = ok && std::fwrite(hiddenWeights_.data(), 1, hiddenWeights_.size(), out) == hiddenWeights_.size();
+    ok = ok && std::fwrite(hiddenBias_.data(), sizeof(std::int32_t), hiddenBias_.size(), out) ==
+                   hiddenBias_.size();
+    ok = ok && std::fwrite(outputWeights_.data(), 1, outputWeights_.size(), out) == outputWeights_.size();
+    ok = ok && std::fwrite(&outputBias_, sizeof(outputBias_), 1, out) == 1;
+    return std::fclose(out) == 0 && ok;
+}
+
+void Network::randomize(std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    auto uniform = [&random](int low, int high) {
+        return low + static_cast<int>(random() % static_cast<std::uint64_t>(high - low + 1));
+    };
+    for (std::int16_t& weight : featureWeights_) weight = static_cast<std::int16_t>(uniform(-24, 24));
+    for (std::int16_t& bias : featureBias_) bias = static_cast<std::int16_t>(uniform(0, 64));
+    for (std::int8_t& weight : hiddenWeights_) weight = static_cast<std::int8_t>(uniform(-64, 64));
+    for (std::int32_t& bias : hiddenBias_) bias = uniform(-2048, 2048);
+    for (std::int8_t& weight : outputWeights_) weight = static_cast<std::int8_t>(uniform(-64, 64));
+    outputBias_ = 0;
+}
+
+int Network::evaluate(const Accumulator& accumulator) const {
+    return toScore(activeKernels().forward(accumulator.values_, hiddenWeights_.data(), hiddenBias_.data(),
+                                           outputWeights_.data(), outputBias_));
+}
+
+int Network::evaluateScalar(const Accumulator& accumulator) const {
+    return toScore(forwardScalar(accumulator.values_, hiddenWeights_.data(), hiddenBias_.data(),
+                                 outputWeights_.data(), outputBias_));
+}
+
+Accumulator::Accumulator() : network_(nullptr), seat_(0) {
+    std::fill(std::begin(values_), std::end(values_), 0);
+}
+
+void Accumulator::refresh(const Network& network, const GameState& state, std::size_t seat) {
+    network_ = &network;
+    seat_ = seat;
+    int features[kMaxActiveFeatures];
+    const int count = activeFeatures(state, seat, features);
+    const std::int16_t* rows[kMaxActiveFeatures];
+    for (int i = 0; i < count; ++i) {
+        rows[i] = &network.featureWeights_[static_cast<std::size_t>(features[i]) * kHidden];
+    }
+    std::copy(network.featureBias_.begin(), network.featureBias_.end(), values_);
+    activeKernels().update(values_, nullptr, 0, rows, count);
+}
+
+void Accumulator::makeMove(const GameState& state, const Move& move) {
+    int removed[kMaxChangedFeatures];
+    int added[kMaxChangedFeatures];
+    int removedCount;
+    int addedCount;
+    changedFeatures(state, move, seat_, removed, removedCount, added, addedCount);
+
+    const std::int16_t* removedRows[kMaxChangedFeatures];
+    const std::int16_t* addedRows[kMaxChangedFeatures];
+    for (int i = 0; i < removedCount; ++i) {
+        removedRows[i] = &network_->featureWeights_[static_cast<std::size_t>(removed[i]) * kHidden];
+    }
+    for (int i = 0; i < addedCount; ++i) {
+        addedRows[i] = &network_->featureWeights_[static_cast<std::size_t>(added[i]) * kHidden];
+    }
+    activeKernels().update(values_, removedRows, removedCount, addedRows, addedCount);
+}
+
+void Accumulator::unmakeMove(const GameState& state, const Move& move) {
+    int removed[kMaxChangedFeatures];
+    int added[kMaxChangedFeatures];
+    int removedCount;
+    int addedCount;
+    changedFeatures(state, move, seat_, removed, removedCount, added, addedCount);
+
+    // 둘 때 켠 것을 끄고 끈 것을 켠다
+    const std::int16_t* removedRows[kMaxChangedFeatures];
+    const std::int16_t* addedRows[kMaxChangedFeatures];
+    for (int i = 0; i < addedCount; ++i) {
+        removedRows[i] = &network_->featureWeights_[static_cast<std::size_t>(added[i]) * kHidden];
+    }
+    for (int i = 0; i < removedCount; ++i) {
+        addedRows[i] = &network_->featureWeights_[static_cast<std::size_t>(removed[i]) * kHidden];
+    }
+    activeKernels().update(values_, removedRows, addedCount, addedRows, removedCount);
+}
+
+bool train(const std::vector<std::string>& recordFiles, const std::string& path,
+           const TrainOptions& options, TrainReport& report, std::ostream& log) {
+    report = TrainReport();
+    Samples samples;
+    GameState state;
+    Move move;
+    int features[kMaxActiveFeatures];
+
+    for (const std::string& recordFile : recordFiles) {
+        MappedFile input;
+        if (!input.open(recordFile)) {
+            return false;
+        }
+        RecordReader reader(input.data(), input.size());
+        record::RecordedGame game;
+        while (reader.next(game)) {
+            const std::size_t mark = samples.targets.size();
+            const std::size_t featureMark = samples.features.size();
+            state.initializePlayers();
+            bool valid = true;
+            for (std::size_t ply = 0; ply < game.moveCount; ++ply) {
+                for (std::size_t seat = 0; seat < GameState::kPlayerCount; ++seat) {
+                    const int count = activeFeatures(state, seat, features);
+                    samples.features.insert(samples.features.end(), features, features + count);
+                    samples.offsets.push_back(static_cast<std::uint32_t>(samples.features.size()));
+                    samples.targets.push_back(game.winner == GameState::kNoWinner           ? 0.25f
+                                              : static_cast<std::size_t>(game.winner) == seat ? 1.0f
+                                                                                              : 0.0f);
+                }
+                if (!record::decodeMove(state, game.moves[ply], move) ||
+                    state.apply(move) != MoveError::None) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (!valid) {
+                samples.targets.resize(mark);
+                samples.offsets.resize(mark + 1);
+                samples.features.resize(featureMark);
+                ++report.invalid;
+                continue;
+            }
+            ++report.games;
+        }
+    }
+    report.samples = samples.targets.size();
+    if (samples.targets.empty()) {
+        return false;
+    }
+
+    std::mt19937_64 random(options.seed);
+    std::uniform_real_distribution<float> firstLayer(-0.05f, 0.05f);
+    std::uniform_real_distribution<float> hiddenLayer(-0.2f, 0.2f);
+    FloatNetwork net;
+    net.featureWeights.resize(static_cast<std::size_t>(kFeatureCount) * kHidden);
+    for (float& weight : net.featureWeights) weight = firstLayer(random);
+    net.featureBias.assign(kHidden, 0.25f);
+    net.hiddenWeights.resize(static_cast<std::size_t>(kHidden2) * kHidden);
+    for (float& weight : net.hiddenWeights) weight = hiddenLayer(random);
+    net.hiddenBias.assign(kHidden2, 0.1f);
+    net.outputWeights.resize(kHidden2);
+    for (float& weight : net.outputWeights) weight = hiddenLayer(random);
+
+    std::vector<std::uint32_t> order(samples.targets.size());
+    std::iota(order.begin(), order.end(), 0u);
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        std::shuffle(order.begin(), order.end(), random);
+        double loss = 0;
+        for (std::uint32_t index : order) {
+            const std::uint32_t begin = samples.offsets[index];
+            const int count = static_cast<int>(samples.offsets[index + 1] - begin);
+            loss += trainSample(net, &samples.features[begin], count, samples.targets[index],
+                                static_cast<float>(options.learningRate));
+        }
+        report.loss = loss / static_cast<double>(order.size());
+        log << "epoch " << epoch << " loss " << report.loss << '\n';
+    }
+
+    Network quantized;
+    for (std::size_t i = 0; i < net.featureWeights.size(); ++i) {
+        quantized.featureWeights_[i] = quantize<std::int16_t>(net.featureWeights[i], kActivationMax, -32767, 32767);
+    }
+    for (int i = 0; i < kHidden; ++i) {
+        quantized.featureBias_[i] = quantize<std::int16_t>(net.featureBias[i], kActivationMax, -32767, 32767);
+    }
+    for (std::size_t i = 0; i < net.hiddenWeights.size(); ++i) {
+        quantized.hiddenWeights_[i] = quantize<std::int8_t>(net.hiddenWeights[i], kWeightScale, -127, 127);
+    }
+    for (int o = 0; o < kHidden2; ++o) {
+        quantized.hiddenBias_[o] = static_cast<std::int32_t>(
+            std::lround(net.hiddenBias[o] * kActivationMax * kWeightScale));
+        quantized.outputWeights_[o] = quantize<std::int8_t>(net.outputWeights[o], kWeightScale, -127, 127);
+    }
+    quantized.outputBias_ = static_cast<std::int32_t>(std::lround(net.outputBias * kActivationMax * kWeightScale));
+    return quantized.save(path);
+}
+
+const char* kernelName() {
+    return activeKernels().name;
+}
+
+}  // namespace nnue
+
+namespace {
+int runTrain(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    nnue::TrainOptions options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--epochs" && i + 1 < argc) {
+            options.epochs = std::atoi(argv[++i]);
+            if (options.epochs < 1) {
+                printUsage();
+                return 1;
+            }
+        } else if (argument == "--rate" && i + 1 < argc) {
+            options.learningRate = std::atof(argv[++i]);
+            if (!(options.learningRate > 0)) {
+                printUsage();
+                return 1;
+            }
+        } else {
+            inputs.push_back(argument);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    nnue::TrainReport report;
+    if (!nnue::train(inputs, argv[0], options, report, std::cout)) {
+        std::cout << "cannot train " << argv[0] << '\n';
+        return 1;
+    }
+    std::cout << "games " << report.games << " (invalid " << report.invalid << "), samples "
+              << report.samples << ", loss " << report.loss << " in " << secondsSince(start) << " s\n";
+    return 0;
+}
+
+int runBench(int argc, char** argv) {
+    nnue::Network network;
+    if (argc > 0) {
+        if (!network.load(argv[0])) {
+            std::cout << "cannot open " << argv[0] << '\n';
+            return 1;
+        }
+    } else {
+        network.randomize(1);
+    }
+
+    // 무작위 게임을 끝까지 (또는 80수까지) 두면서 관점 좌석의 누산기를 증분으로 따라가고
+    // 매 수 전체 재계산, 스칼라 순전파와 맞춰 본다. 되돌리면서도 똑같이 확인한다.
+    constexpr int kGames = 200;
+    constexpr int kMaxPlies = 80;
+    std::mt19937_64 random(0x4E4E);
+    std::vector<GameState> positions;
+    GameState::MoveList moves;
+    int mismatches = 0;
+    for (int game = 0; game < kGames; ++game) {
+        GameState state;
+        const std::size_t seat = static_cast<std::size_t>(game) % GameState::kPlayerCount;
+        nnue::Accumulator incremental;
+        nnue::Accumulator fresh;
+        incremental.refresh(network, state, seat);
+        auto check = [&]() {
+            fresh.refresh(network, state, seat);
+            if (!std::equal(incremental.values(), incremental.values() + nnue::kHidden, fresh.values()) ||
+                network.evaluate(incremental) != network.evaluateScalar(incremental)) {
+                ++mismatches;
+            }
+        };
+        std::vector<Move> played;
+        for (int ply = 0; ply < kMaxPlies && !state.isGameOver(); ++ply) {
+            state.legalMoves(moves);
+            if (moves.size() == 0) break;
+            const Move move = moves[static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()))];
+            incremental.makeMove(state, move);
+            state.makeMove(move);
+            played.push_back(move);
+            check();
+            if (!state.isGameOver()) positions.push_back(state);
+        }
+        while (!played.empty()) {
+            state.unmakeMove(played.back());
+            incremental.unmakeMove(state, played.back());
+            played.pop_back();
+            check();
+        }
+    }
+
+    std::vector<nnue::Accumulator> accumulators(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        accumulators[i].refresh(network, positions[i], positions[i].currentTurn());
+    }
+
+    // 순전파만
+    const int rounds = 20;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const nnue::Accumulator& accumulator : accumulators) checksum += network.evaluate(accumulator);
+    }
+    const double evaluateSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const nnue::Accumulator& accumulator : accumulators) checksum -= network.evaluateScalar(accumulator);
+    }
+    const double scalarSeconds = secondsSince(start);
+    const double evaluations = static_cast<double>(accumulators.size()) * rounds;
+
+    // 탐색 잎처럼: 국면마다 합법수 전부를 두고, 평가하고, 되돌린다. 손으로 만든 평가와 나란히 잰다.
+    std::uint64_t leaves = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        GameState& state = positions[i];
+        nnue::Accumulator& accumulator = accumulators[i];
+        state.legalMoves(moves);
+        for (const Move& move : moves) {
+            accumulator.makeMove(state, move);
+            state.makeMove(move);
+            checksum += network.evaluate(accumulator);
+            state.unmakeMove(move);
+            accumulator.unmakeMove(state, move);
+            ++leaves;
+        }
+    }
+    const double networkLeafSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (GameState& state : positions) {
+        const std::size_t seat = state.currentTurn();
+        state.legalMoves(moves);
+        for (const Move& move : moves) {
+            state.makeMove(move);
+            checksum -= AlphaBetaSearch::evaluate(state, seat);
+            state.unmakeMove(move);
+        }
+    }
+    const double handcraftedLeafSeconds = secondsSince(start);
+
+    std::cout << "kernel " << nnue::kernelName() << ", " << nnue::kFeatureCount << " features -> "
+              << nnue::kHidden << " -> " << nnue::kHidden2 << " -> 1\n"
+              << "incremental/refresh/scalar mismatches " << mismatches << '\n'
+              << "evaluate: " << static_cast<std::uint64_t>(evaluations / evaluateSeconds) << " /s ("
+              << nnue::kernelName() << "), " << static_cast<std::uint64_t>(evaluations / scalarSeconds)
+              << " /s (scalar)\n"
+              << "make + evaluate + unmake: " << static_cast<std::uint64_t>(leaves / networkLeafSeconds)
+              << " /s (network), " << static_cast<std::uint64_t>(leaves / handcraftedLeafSeconds)
+              << " /s (handcrafted)\n";
+    benchSink = checksum;
+    return mismatches == 0 ? 0 : 1;
+}
+}  // namespace
+
+int runNnueCommand(int argc, char** argv) {
+    if (argc >= 1 && std::string(argv[0]) == "train") {
+        return runTrain(argc - 1, argv + 1);
+    }
+    if (argc >= 1 && std::string(argv[0]) == "bench") {
+        return runBench(argc - 1, argv + 1);
+    }
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "GameState.h"
+#include "Move.h"
+
+// 수마다 증분 갱신되는 작은 신경망 평가 (NNUE 방식, 9x9 GameState 전용).
+//
+// 입력은 한 좌석(관점)에서 본 희소 특징이다. 보드는 관점 좌석의 목표가 0행이 되도록 돌려서 보고
+// (목표가 열이면 벽 방향도 바뀐다), 좌석은 관점 좌석에서부터 센 상대 번호로 본다.
+//   폰 셀 (좌석 4 x 셀 81), 벽 슬롯 128, 남은 벽 수 (좌석 4 x 0..10), 차례 (좌석 4)
+// 첫 층은 켜진 특징의 가중치 합이라 누산기(int16 kHidden개)에 더하고 빼기만 하면 되고,
+// 수 하나는 특징을 많아야 셋 끄고 셋 켠다. 그다음 층들은 clipped ReLU를 거친 uint8과 int8 가중치의
+// 내적(int32 합)이다. AVX2가 있으면 누산기 갱신과 내적을 256비트로 하고, 없으면 같은 정수 연산을
+// 스칼라로 한다. 두 경로의 결과는 비트 단위로 같다.
+namespace nnue {
+
+constexpr int kPawnFeatures = GameState::kPlayerCount * Board::kCellCount;
+constexpr int kWallFeatures = Board::kWallSlotCount;
+constexpr int kWallCountFeatures = GameState::kPlayerCount * (GameState::kWallsPerPlayer + 1);
+constexpr int kTurnFeatures = GameState::kPlayerCount;
+constexpr int kFeatureCount = kPawnFeatures + kWallFeatures + kWallCountFeatures + kTurnFeatures;
+// 한 국면에서 동시에 켜지는 특징 수의 상한
+constexpr int kMaxActiveFeatures =
+    GameState::kPlayerCount * (1 + GameState::kWallsPerPlayer) + GameState::kPlayerCount + 1;
+constexpr int kMaxChangedFeatures = 3;
+
+constexpr int kHidden = 128;   // 누산기 폭
+constexpr int kHidden2 = 32;
+// 출력 로짓 1이 평가 점수로 몇 점인가 (AlphaBetaSearch::evaluate와 비슷한 크기가 되도록)
+constexpr int kScoreScale = 400;
+
+// 관점 seat에서 본 지금 켜진 특징들. 개수를 돌려준다 (kMaxActiveFeatures 이하).
+int activeFeatures(const GameState& state, std::size_t seat, int* features);
+// state(두기 전 국면)에서 move를 두면 관점 seat에서 꺼지는 특징과 켜지는 특징
+void changedFeatures(const GameState& state, const Move& move, std::size_t seat,
+                     int* removed, int& removedCount, int* added, int& addedCount);
+
+class Accumulator;
+
+struct TrainOptions {
+    int epochs = 10;
+    double learningRate = 0.01;
+    std::uint64_t seed = 1;
+};
+
+struct TrainReport {
+    std::uint64_t games = 0;
+    std::uint64_t invalid = 0;
+    std::uint64_t samples = 0;   // 국면 x 관점 좌석 4
+    double loss = 0;             // 마지막 epoch의 평균 교차 엔트로피
+};
+
+// 양자화된 가중치. 읽기만 하므로 여러 탐색 스레드가 같이 쓴다.
+class Network {
+public:
+    Network();
+
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    // 작은 무작위 가중치 (학습 없이 속도와 일치를 재는 bench용)
+    void randomize(std::uint64_t seed);
+
+    // 누산기 관점 좌석 기준 점수
+    int evaluate(const Accumulator& accumulator) const;
+    // 늘 스칼라로 돈다 (비교와 측정용)
+    int evaluateScalar(const Accumulator& accumulator) const;
+
+private:
+    friend class Accumulator;
+    friend bool train(const std::vector<std::string>& recordFiles, const std::string& path,
+                      const TrainOptions& options, TrainReport& report, std::ostream& log);
+
+    std::vector<std::int16_t> featureWeights_;  // [kFeatureCount][kHidden]
+    std::vector<std::int16_t> featureBias_;     // [kHidden]
+    std::vector<std::int8_t> hiddenWeights_;    // [kHidden2][kHidden]
+    std::vector<std::int32_t> hiddenBias_;      // [kHidden2]
+    std::vector<std::int8_t> outputWeights_;    // [kHidden2]
+    std::int32_t outputBias_;
+};
+
+// 한 관점 좌석의 첫 층 출력. 탐색은 루트 좌석 관점 하나만 들고 다닌다.
+class Accumulator {
+public:
+    Accumulator();
+
+    // state를 처음부터 다시 센다
+    void refresh(const Network& network, const GameState& state, std::size_t seat);
+    // state는 두 함수 모두 move를 두기 전 국면이다: makeMove는 state.makeMove 전에,
+    // unmakeMove는 state.unmakeMove 뒤에 부른다.
+    void makeMove(const GameState& state, const Move& move);
+    void unmakeMove(const GameState& state, const Move& move);
+
+    std::size_t seat() const { return seat_; }
+    const std::int16_t* values() const { return values_; }
+
+private:
+    friend class Network;
+
+    const Network* network_;
+    std::size_t seat_;
+    std::int16_t values_[kHidden];
+};
+
+// 기보 파일들의 모든 국면을 좌석마다 (그 좌석이 이겼으면 1, 무승부 1/4, 졌으면 0)으로 float 학습한 뒤
+// 양자화해서 path에 쓴다. epoch마다 평균 손실을 log에 출력한다.
+bool train(const std::vector<std::string>& recordFiles, const std::string& path,
+           const TrainOptions& options, TrainReport& report, std::ostream& log);
+
+// Network::evaluate와 누산기 갱신이 쓰는 구현 ("avx2" 또는 "scalar")
+const char* kernelName();
+
+}  // namespace nnue
+
+// "project2 nnue train <out> [--epochs n] [--rate r] <record files...>"
+// "project2 nnue bench [network]" : 증분 누산기와 전체 재계산, AVX2와 스칼라가 같은지 맞춰 보고 평가/초를 출력한다.
+int runNnueCommand(int argc, char** argv);
+
+#endif  // NNUE_HPP
@@ -0,0 +1,197 @@
+#include "Notation.h"
+
+#include <sstream>
+#include <vector>
+
+namespace {
+inline Position makePos(int r, int c){
+    Position p;
+    p.row=r;
+    p.col=c;
+    return p;
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream stream(text);
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+bool parseNumber(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 3) {
+        return false;
+    }
+    value = 0;
+    for (char ch : text) {
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + (ch - '0');
+    }
+    return true;
+}
+}  // namespace
+
+namespace notation {
+
+const char* const kStartPosition = "a5,i5,e1,e9 - 10,10,10,10 1";
+
+std::string cellName(int cell) {
+    const Position position = Board::cellPosition(cell);
+    std::string name(1, static_cast<char>('a' + position.col));
+    name += std::to_string(position.row + 1);
+    return name;
+}
+
+std::string wallName(int slot) {
+    const Position position = Board::wallSlotPosition(slot);
+    std::string name = std::to_string(position.row + 1);
+    name += static_cast<char>('A' + position.col);
+    name += Board::isHorizontalSlot(slot) ? 'h' : 'v';
+    return name;
+}
+
+std::string moveName(const Move& move) {
+    if (move.isWall()) {
+        return wallName(move.wallSlot());
+    }
+    std::string name = cellName(move.to);
+    if (move.isSwap()) {
+        name += 'x';
+        name += std::to_string(move.swapWith + 1);
+    }
+    return name;
+}
+
+bool parseCell(const std::string& text, int& cell) {
+    if (text.size() != 2) {
+        return false;
+    }
+    const int col = text[0] - 'a';
+    const int row = text[1] - '1';
+    if (col < 0 || col >= Board::kSize || row < 0 || row >= Board::kSize) {
+        return false;
+    }
+    cell = Board::cellIndex(row, col);
+    return true;
+}
+
+bool parseWall(const std::string& text, int& slot) {
+    if (text.size() != 3) {
+        return false;
+    }
+    const int row = text[0] - '1';
+    const int col = text[1] - 'A';
+    if (row < 0 || row >= Board::kWallGrid || col < 0 || col >= Board::kWallGrid) {
+        return false;
+    }
+    if (text[2] != 'h' && text[2] != 'v') {
+        return false;
+    }
+    slot = Board::wallSlot(makePos(row, col), text[2] == 'h');
+    return true;
+}
+
+bool parseMove(const GameState& state, const std::string& text, Move& move) {
+    int slot;
+    if (parseWall(text, slot)) {
+        move = Move::wall(slot);
+        return true;
+    }
+
+    const int from = state.pawnCell(state.currentTurn());
+    int to;
+    if (text.size() >= 2 && parseCell(text.substr(0, 2), to)) {
+        if (text.size() == 2) {
+            move = Move::pawn(from, to);
+            return true;
+        }
+        int seat;
+        if (text[2] == 'x' && parseNumber(text.substr(3), seat) &&
+            seat >= 1 && seat <= static_cast<int>(state.playerCount())) {
+            move = Move::pawn(from, to, seat - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string formatPosition(const GameState& state) {
+    std::string text;
+    for (std::size_t i = 0; i < state.playerCount(); ++i) {
+        if (i) text += ',';
+        text += cellName(state.pawnCell(i));
+    }
+
+    text += ' ';
+    bool anyWall = false;
+    for (int slot = 0; slot < Board::kWallSlotCount; ++slot) {
+        if (!state.board().hasWall(Board::wallSlotPosition(slot), Board::isHorizontalSlot(slot))) {
+            continue;
+        }
+        if (anyWall) text += ',';
+        text += wallName(slot);
+        anyWall = true;
+    }
+    if (!anyWall) {
+        text += '-';
+    }
+
+    text += ' ';
+    for (std::size_t i = 0; i < state.playerCount(); ++i) {
+        if (i) text += ',';
+        text += std::to_string(state.wallsRemaining(i));
+    }
+
+    text += ' ';
+    text += std::to_string(state.currentTurn() + 1);
+    return text;
+}
+
+bool parsePosition(const std::string& text, GameState& state) {
+    std::istringstream stream(text);
+    std::string pawnField, wallField, countField, turnField, extra;
+    if (!(stream >> pawnField >> wallField >> countField >> turnField) || (stream >> extra)) {
+        return false;
+    }
+
+    const std::vector<std::string> pawnNames = split(pawnField, ',');
+    const std::vector<std::string> countNames = split(countField, ',');
+    if (pawnNames.size() != GameState::kPlayerCount ||
+        countNames.size() != GameState::kPlayerCount) {
+        return false;
+    }
+
+    Position pawns[GameState::kPlayerCount];
+    int wallsRemaining[GameState::kPlayerCount];
+    for (int i = 0; i < GameState::kPlayerCount; ++i) {
+        int cell;
+        if (!parseCell(pawnNames[i], cell) || !parseNumber(countNames[i], wallsRemaining[i])) {
+            return false;
+        }
+        pawns[i] = Board::cellPosition(cell);
+    }
+
+    std::vector<int> wallSlots;
+    if (wallField != "-") {
+        for (const std::string& name : split(wallField, ',')) {
+            int slot;
+            if (!parseWall(name, slot)) {
+                return false;
+            }
+            wallSlots.push_back(slot);
+        }
+    }
+
+    int turn;
+    if (!parseNumber(turnField, turn) || turn < 1) {
+        return false;
+    }
+    return state.setPosition(pawns, wallsRemaining, wallSlots, static_cast<std::size_t>(turn - 1));
+}
+
+}  // namespace notation
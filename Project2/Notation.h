@@ -0,0 +1,37 @@
+#pragma once
+#ifndef NOTATION_HPP
+#define NOTATION_HPP
+
+#include <string>
+
+#include "GameState.h"
+#include "Move.h"
+
+// 국면과 수의 문자열 표기.
+//
+// 셀: 열 a~i + 행 1~9 (예: 플레이어 1 시작 칸 "a5")
+// 벽: 콘솔 입력과 같은 행 1~8 + 열 A~H + h/v (예: "3Ch")
+// 수: 폰은 도착 셀, 자리바꾸기는 도착 셀 + 'x' + 좌석 번호 (예: "c3x2"), 벽은 벽 표기
+//
+// 국면은 공백으로 구분한 네 필드:
+//   <폰 4개> <벽 목록 또는 -> <남은 벽 4개> <차례>
+// 예) 시작 국면 "a5,i5,e1,e9 - 10,10,10,10 1"
+namespace notation {
+
+extern const char* const kStartPosition;
+
+std::string cellName(int cell);
+std::string wallName(int slot);
+std::string moveName(const Move& move);
+
+bool parseCell(const std::string& text, int& cell);
+bool parseWall(const std::string& text, int& slot);
+// 현재 차례 플레이어의 수로 해석한다 (합법성 검사는 하지 않는다)
+bool parseMove(const GameState& state, const std::string& text, Move& move);
+
+std::string formatPosition(const GameState& state);
+bool parsePosition(const std::string& text, GameState& state);
+
+}  // namespace notation
+
+#endif  // NOTATION_HPP
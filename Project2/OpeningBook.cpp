@@ -0,0 +1,282 @@
+#include "OpeningBook.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "GameRecord.h"
+#include "Notation.h"
+
+namespace {
+constexpr char kMagic[8] = {'Q', 'B', 'O', 'O', 'K', '0', '0', '1'};
+
+// 기보 한 수에서 나온 표본
+struct Sample {
+    std::uint64_t hash;
+    std::uint8_t move;
+    std::uint8_t result;  // 0 패, 1 무, 2 승 (수를 둔 좌석 기준)
+};
+
+double expectedScore(const OpeningBook::Entry& entry) {
+    return (entry.wins + entry.draws * 0.25 + 1.0) / (entry.games + 2.0);
+}
+
+void printUsage() {
+    std::cout << "usage: project2 book build <out> [--plies n] [--min-games n] <record files...>\n"
+              << "       project2 book probe <book> [position]\n";
+}
+}  // namespace
+
+struct OpeningBook::Header {
+    char magic[8];
+    std::uint64_t count;
+};
+
+static_assert(sizeof(OpeningBook::Entry) == 24, "book entries are 24 bytes on disk");
+
+bool OpeningBook::build(const std::vector<std::string>& recordFiles, const std::string& path,
+                        const BuildOptions& options, BuildReport& report) {
+    report = BuildReport();
+    std::vector<Sample> samples;
+    GameState state;
+    Move move;
+
+    for (const std::string& recordFile : recordFiles) {
+        MappedFile input;
+        if (!input.open(recordFile)) {
+            return false;
+        }
+        RecordReader reader(input.data(), input.size());
+        record::RecordedGame game;
+        while (reader.next(game)) {
+            const std::size_t mark = samples.size();
+            const std::size_t plies = std::min<std::size_t>(game.moveCount,
+                                                            static_cast<std::size_t>(options.maxPly));
+            state.initializePlayers();
+            bool valid = true;
+            for (std::size_t ply = 0; ply < plies; ++ply) {
+                const int seat = static_cast<int>(state.currentTurn());
+                const std::uint8_t result = game.winner == GameState::kNoWinner ? 1
+                                            : game.winner == seat                ? 2
+                                                                                 : 0;
+                samples.push_back(Sample{state.hash(), game.moves[ply], result});
+                if (!record::decodeMove(state, game.moves[ply], move) ||
+                    state.apply(move) != MoveError::None) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (!valid) {
+                samples.resize(mark);
+                ++report.invalid;
+                continue;
+            }
+            ++report.games;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.move < b.move;
+    });
+
+    // 같은 (국면, 수)를 하나로 모은다
+    std::vector<Entry> entries;
+    for (std::size_t i = 0; i < samples.size();) {
+        Entry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.hash = samples[i].hash;
+        entry.move = samples[i].move;
+        for (; i < samples.size() && samples[i].hash == entry.hash && samples[i].move == entry.move; ++i) {
+            ++entry.games;
+            entry.wins += samples[i].result == 2;
+            entry.draws += samples[i].result == 1;
+        }
+        if (entry.games >= static_cast<std::uint32_t>(options.minGames)) {
+            if (entries.empty() || entries.back().hash != entry.hash) {
+                ++report.positions;
+            }
+            entries.push_back(entry);
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.games > b.games;
+    });
+    report.entries = entries.size();
+
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.count = entries.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    if (!entries.empty()) {
+        ok = ok && std::fwrite(entries.data(), sizeof(Entry), entries.size(), out) == entries.size();
+    }
+    return std::fclose(out) == 0 && ok;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.count != (file_.size() - sizeof(Header)) / sizeof(Entry)) {
+        close();
+        return false;
+    }
+    entries_ = reinterpret_cast<const Entry*>(file_.data() + sizeof(Header));
+    count_ = static_cast<std::size_t>(header.count);
+    return true;
+}
+
+void OpeningBook::close() {
+    file_.close();
+    entries_ = nullptr;
+    count_ = 0;
+}
+
+void OpeningBook::find(std::uint64_t hash, const Entry*& first, const Entry*& last) const {
+    first = std::lower_bound(entries_, entries_ + count_, hash,
+                             [](const Entry& entry, std::uint64_t key) { return entry.hash < key; });
+    last = std::upper_bound(first, entries_ + count_, hash,
+                            [](std::uint64_t key, const Entry& entry) { return key < entry.hash; });
+}
+
+bool OpeningBook::probe(const GameState& state, Move& move, const Entry** entry) const {
+    if (!entries_ || state.isGameOver()) {
+        return false;
+    }
+    const Entry* first;
+    const Entry* last;
+    find(state.hash(), first, last);
+    if (first == last) {
+        return false;
+    }
+
+    // 해시 충돌에 대비해 후보마다 합법수인지 확인한다
+    const Entry* best = nullptr;
+    Move bestMove;
+    for (const Entry* candidate = first; candidate != last; ++candidate) {
+        Move decoded;
+        if (!record::decodeMove(state, candidate->move, decoded) ||
+            state.checkMove(decoded) != MoveError::None) {
+            continue;
+        }
+        if (!best || expectedScore(*candidate) > expectedScore(*best)) {
+            best = candidate;
+            bestMove = decoded;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+    move = bestMove;
+    if (entry) {
+        *entry = best;
+    }
+    return true;
+}
+
+namespace {
+int runBuild(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    OpeningBook::BuildOptions options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if ((argument == "--plies" || argument == "--min-games") && i + 1 < argc) {
+            const int value = std::atoi(argv[++i]);
+            if (value < 1) {
+                printUsage();
+                return 1;
+            }
+            (argument == "--plies" ? options.maxPly : options.minGames) = value;
+        } else {
+            inputs.push_back(argument);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    OpeningBook::BuildReport report;
+    if (!OpeningBook::build(inputs, argv[0], options, report)) {
+        std::cout << "cannot build " << argv[0] << '\n';
+        return 1;
+    }
+    std::cout << "games " << report.games << " (invalid " << report.invalid << "), positions "
+              << report.positions << ", entries " << report.entries << " in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+              << " s\n";
+    return 0;
+}
+
+int runProbe(int argc, char** argv) {
+    if (argc < 1) {
+        printUsage();
+        return 1;
+    }
+    std::string position = notation::kStartPosition;
+    if (argc > 1) {
+        position.clear();
+        for (int i = 1; i < argc; ++i) {
+            if (i > 1) position += ' ';
+            position += argv[i];
+        }
+    }
+    GameState state;
+    if (!notation::parsePosition(position, state)) {
+        std::cout << "Invalid position \"" << position << "\"\n";
+        return 1;
+    }
+    OpeningBook book;
+    if (!book.open(argv[0])) {
+        std::cout << "cannot open book " << argv[0] << '\n';
+        return 1;
+    }
+
+    const OpeningBook::Entry* first;
+    const OpeningBook::Entry* last;
+    book.find(state.hash(), first, last);
+    std::cout << "book " << book.size() << " entries, " << (last - first) << " for this position\n";
+    for (const OpeningBook::Entry* entry = first; entry != last; ++entry) {
+        Move move;
+        if (!record::decodeMove(state, entry->move, move)) {
+            continue;
+        }
+        std::cout << "  " << notation::moveName(move) << ": " << entry->games << " games, "
+                  << entry->wins << " wins, " << entry->draws << " draws ("
+                  << 100.0 * expectedScore(*entry) << "%)\n";
+    }
+    Move move;
+    if (book.probe(state, move)) {
+        std::cout << "book move " << notation::moveName(move) << '\n';
+    }
+    return 0;
+}
+}  // namespace
+
+int runBookCommand(int argc, char** argv) {
+    if (argc >= 1 && std::string(argv[0]) == "build") {
+        return runBuild(argc - 1, argv + 1);
+    }
+    if (argc >= 1 && std::string(argv[0]) == "probe") {
+        return runProbe(argc - 1, argv + 1);
+    }
+    printUsage();
+    return 1;
+}
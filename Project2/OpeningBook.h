@@ -0,0 +1,69 @@
+#pragma once
+#ifndef OPENINGBOOK_HPP
+#define OPENINGBOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+// 기보에서 모은 오프닝 통계. 국면 해시와 그 국면에서 둔 수마다 게임 수와 승패를 센다.
+//
+// 파일 배치 (리틀 엔디언): Header 다음에 Entry가 (hash, games 내림차순)으로 정렬돼 있다.
+// mmap으로 열고, 찾기는 이진 탐색 한 번이다.
+class OpeningBook {
+public:
+    struct Entry {
+        std::uint64_t hash;     // 수를 두기 전 국면의 GameState::hash()
+        std::uint32_t games;
+        std::uint32_t wins;     // 이 수를 둔 좌석이 이긴 게임
+        std::uint32_t draws;
+        std::uint8_t move;      // record::encodeMove 코드
+        std::uint8_t reserved[3];
+    };
+
+    struct BuildOptions {
+        int maxPly = 24;        // 게임마다 앞에서 몇 수까지 넣을지
+        int minGames = 2;       // 이보다 적게 나온 수는 버린다
+    };
+
+    struct BuildReport {
+        std::uint64_t games = 0;
+        std::uint64_t invalid = 0;
+        std::uint64_t positions = 0;
+        std::uint64_t entries = 0;
+    };
+
+    // 기보 파일들에서 책을 만든다
+    static bool build(const std::vector<std::string>& recordFiles, const std::string& path,
+                      const BuildOptions& options, BuildReport& report);
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return entries_ != nullptr; }
+    std::size_t size() const { return count_; }
+
+    // state 국면의 항목 [first, last)
+    void find(std::uint64_t hash, const Entry*& first, const Entry*& last) const;
+
+    // 책에 있는 합법수 중 기대 승률((wins + draws/4 + 1) / (games + 2))이 가장 높은 수.
+    // entry가 있으면 고른 항목을 가리킨다.
+    bool probe(const GameState& state, Move& move, const Entry** entry = nullptr) const;
+
+private:
+    struct Header;
+
+    MappedFile file_;
+    const Entry* entries_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+// "project2 book build <out> [--plies n] [--min-games n] <record files...>"
+// "project2 book probe <book> [position]"
+int runBookCommand(int argc, char** argv);
+
+#endif  // OPENINGBOOK_HPP
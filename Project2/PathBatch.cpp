@@ -0,0 +1,315 @@
+#include "PathBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Simd.h"
+
+namespace {
+constexpr int kLanes = 4;                   // AVX2 레지스터 하나의 64비트 레인
+constexpr int kGroups = 2;
+constexpr int kBatch = kLanes * kGroups;
+constexpr int kAllLanes = (1 << kLanes) - 1;
+// 질의를 레인으로 옮길 때 쓰는 줄 번호 (앞의 넷은 방향)
+constexpr int kStartRow = Board::kDirectionCount;
+constexpr int kGoalRow = Board::kDirectionCount + 1;
+// wallCandidateDistances가 한 번에 커널로 넘기는 벽 수
+constexpr int kWallChunk = 16;
+
+using Kernel = void (*)(const PathQuery*, int, int*);
+
+CellSet expand(const CellSet& frontier, const std::array<CellSet, Board::kDirectionCount>& open) {
+    return (frontier & open[Board::kSouth]).shiftUp(Board::kSize) |
+           (frontier & open[Board::kNorth]).shiftDown(Board::kSize) |
+           (frontier & open[Board::kEast]).shiftUp(1) |
+           (frontier & open[Board::kWest]).shiftDown(1);
+}
+
+void shortestPathsScalar(const PathQuery* queries, int count, int* distances) {
+    for (int i = 0; i < count; ++i) {
+        const PathQuery& query = queries[i];
+        CellSet reached = query.start;
+        CellSet frontier = reached;
+        int distance = 0;
+        while (!reached.intersects(query.goal)) {
+            if (frontier.none()) {
+                distance = Board::kUnreachable;
+                break;
+            }
+            frontier = expand(frontier, query.open) & ~reached;
+            reached |= frontier;
+            ++distance;
+        }
+        distances[i] = distance;
+    }
+}
+
+#ifdef SIMD_X86
+// 레인마다 아래/위 64비트를 나눠 담은 CellSet 4개
+struct Lanes {
+    __m256i lo;
+    __m256i hi;
+};
+
+SIMD_AVX2 inline Lanes laneAnd(const Lanes& a, const Lanes& b) {
+    return Lanes{_mm256_and_si256(a.lo, b.lo), _mm256_and_si256(a.hi, b.hi)};
+}
+
+// 비어 있는 레인의 비트
+SIMD_AVX2 inline int emptyLanes(const Lanes& a) {
+    const __m256i zero = _mm256_cmpeq_epi64(_mm256_or_si256(a.lo, a.hi), _mm256_setzero_si256());
+    return _mm256_movemask_pd(_mm256_castsi256_pd(zero));
+}
+
+// CellSet::shiftUp / shiftDown과 같은 계산을 레인마다 한다
+template <int Shift>
+SIMD_AVX2 inline Lanes laneShiftUp(const Lanes& a) {
+    return Lanes{_mm256_slli_epi64(a.lo, Shift),
+                 _mm256_or_si256(_mm256_slli_epi64(a.hi, Shift), _mm256_srli_epi64(a.lo, 64 - Shift))};
+}
+
+template <int Shift>
+SIMD_AVX2 inline Lanes laneShiftDown(const Lanes& a) {
+    return Lanes{_mm256_or_si256(_mm256_srli_epi64(a.lo, Shift), _mm256_slli_epi64(a.hi, 64 - Shift)),
+                 _mm256_srli_epi64(a.hi, Shift)};
+}
+
+SIMD_AVX2 inline Lanes loadLanes(const std::uint64_t* lo, const std::uint64_t* hi) {
+    return Lanes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo)),
+                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi))};
+}
+
+SIMD_AVX2 void shortestPathsAvx2(const PathQuery* queries, int count, int* distances) {
+    // 레지스터 쌍 kGroups개를 번갈아 넓혀서 한 번에 kGroups * 4개 질의를 돈다
+    for (int base = 0; base < count; base += kBatch) {
+        const int used = std::min(kBatch, count - base);
+
+        // 빈 레인은 출발이 없어서 첫 층에서 끝난다
+        std::uint64_t lo[Board::kDirectionCount + 2][kBatch] = {};
+        std::uint64_t hi[Board::kDirectionCount + 2][kBatch] = {};
+        for (int lane = 0; lane < used; ++lane) {
+            const PathQuery& query = queries[base + lane];
+            for (int d = 0; d < Board::kDirectionCount; ++d) {
+                lo[d][lane] = query.open[d].lo;
+                hi[d][lane] = query.open[d].hi;
+            }
+            lo[kStartRow][lane] = query.start.lo;
+            hi[kStartRow][lane] = query.start.hi;
+            lo[kGoalRow][lane] = query.goal.lo;
+            hi[kGoalRow][lane] = query.goal.hi;
+        }
+
+        Lanes open[kGroups][Board::kDirectionCount];
+        Lanes goal[kGroups];
+        Lanes reached[kGroups];
+        Lanes frontier[kGroups];
+        for (int g = 0; g < kGroups; ++g) {
+            for (int d = 0; d < Board::kDirectionCount; ++d) {
+                open[g][d] = loadLanes(lo[d] + g * kLanes, hi[d] + g * kLanes);
+            }
+            goal[g] = loadLanes(lo[kGoalRow] + g * kLanes, hi[kGoalRow] + g * kLanes);
+            reached[g] = loadLanes(lo[kStartRow] + g * kLanes, hi[kStartRow] + g * kLanes);
+            frontier[g] = reached[g];
+        }
+
+        int result[kBatch] = {};
+        int done[kGroups] = {};
+        for (int level = 0;; ++level) {
+            bool finished = true;
+            for (int g = 0; g < kGroups; ++g) {
+                const int hit = ~emptyLanes(laneAnd(reached[g], goal[g])) & ~done[g] & kAllLanes;
+                const int stuck = emptyLanes(frontier[g]) & ~done[g] & ~hit & kAllLanes;
+                if (hit | stuck) {
+                    for (int lane = 0; lane < kLanes; ++lane) {
+                        if (hit & (1 << lane)) result[g * kLanes + lane] = level;
+                        if (stuck & (1 << lane)) result[g * kLanes + lane] = Board::kUnreachable;
+                    }
+                    done[g] |= hit | stuck;
+                }
+                finished = finished && done[g] == kAllLanes;
+            }
+            if (finished) {
+                break;
+            }
+
+            for (int g = 0; g < kGroups; ++g) {
+                const Lanes south = laneShiftUp<Board::kSize>(laneAnd(frontier[g], open[g][Board::kSouth]));
+                const Lanes north = laneShiftDown<Board::kSize>(laneAnd(frontier[g], open[g][Board::kNorth]));
+                const Lanes east = laneShiftUp<1>(laneAnd(frontier[g], open[g][Board::kEast]));
+                const Lanes west = laneShiftDown<1>(laneAnd(frontier[g], open[g][Board::kWest]));
+                const __m256i nextLo = _mm256_or_si256(_mm256_or_si256(south.lo, north.lo),
+                                                       _mm256_or_si256(east.lo, west.lo));
+                const __m256i nextHi = _mm256_or_si256(_mm256_or_si256(south.hi, north.hi),
+                                                       _mm256_or_si256(east.hi, west.hi));
+                frontier[g].lo = _mm256_andnot_si256(reached[g].lo, nextLo);
+                frontier[g].hi = _mm256_andnot_si256(reached[g].hi, nextHi);
+                reached[g].lo = _mm256_or_si256(reached[g].lo, frontier[g].lo);
+                reached[g].hi = _mm256_or_si256(reached[g].hi, frontier[g].hi);
+            }
+        }
+        std::copy(result, result + used, distances + base);
+    }
+}
+
+#endif  // SIMD_X86
+
+Kernel selectKernel() {
+#ifdef SIMD_X86
+    if (cpuHasAvx2()) {
+        return shortestPathsAvx2;
+    }
+#endif
+    return shortestPathsScalar;
+}
+
+Kernel activeKernel() {
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+void batchShortestPaths(const PathQuery* queries, int count, int* distances) {
+    activeKernel()(queries, count, distances);
+}
+
+void batchShortestPathsScalar(const PathQuery* queries, int count, int* distances) {
+    shortestPathsScalar(queries, count, distances);
+}
+
+const char* batchKernelName() {
+    return activeKernel() == shortestPathsScalar ? "scalar" : "avx2";
+}
+
+void wallCandidateDistances(const GameState& state, const Move* walls, int count, int* distances) {
+    PathQuery queries[kWallChunk * GameState::kPlayerCount];
+    for (int base = 0; base < count; base += kWallChunk) {
+        const int chunk = std::min(kWallChunk, count - base);
+        for (int w = 0; w < chunk; ++w) {
+            const int slot = walls[base + w].wallSlot();
+            std::array<CellSet, Board::kDirectionCount> open = state.board().openEdges();
+            Board::closeWallEdges(Board::wallSlotPosition(slot), Board::isHorizontalSlot(slot), open);
+            for (int seat = 0; seat < GameState::kPlayerCount; ++seat) {
+                PathQuery& query = queries[w * GameState::kPlayerCount + seat];
+                query.open = open;
+                query.start = CellSet::single(state.pawnCell(seat));
+                query.goal = Board::goalMask(state.goalOf(seat));
+            }
+        }
+        batchShortestPaths(queries, chunk * GameState::kPlayerCount,
+                           distances + base * GameState::kPlayerCount);
+    }
+}
+
+int runPathBenchCommand(int argc, char** argv) {
+    int positions = 2000;
+    if (argc > 0) positions = std::atoi(argv[0]);
+    if (positions <= 0) {
+        std::cout << "usage: project2 path-bench [positions]\n";
+        return 1;
+    }
+
+    // 무작위로 몇 수 둔 국면들. 벽이 많이 깔리도록 벽 수를 자주 고른다
+    std::mt19937_64 random(0x5EED);
+    std::vector<GameState> states;
+    std::vector<std::vector<Move>> walls;
+    GameState::MoveList moves;
+    while (static_cast<int>(states.size()) < positions) {
+        GameState state;
+        const int plies = static_cast<int>(random() % 40);
+        for (int ply = 0; ply < plies && !state.isGameOver(); ++ply) {
+            state.legalMoves(moves);
+            if (moves.size() == 0) break;
+            state.makeMove(moves[static_cast<int>(random() % static_cast<std::uint64_t>(moves.size()))]);
+        }
+        if (state.isGameOver()) {
+            continue;
+        }
+        state.legalMoves(moves);
+        std::vector<Move> candidates;
+        for (const Move& move : moves) {
+            if (move.isWall()) candidates.push_back(move);
+        }
+        if (candidates.empty()) {
+            continue;
+        }
+        states.push_back(state);
+        walls.push_back(candidates);
+    }
+
+    std::size_t total = 0;
+    for (const std::vector<Move>& candidates : walls) {
+        total += candidates.size();
+    }
+    const std::size_t seats = GameState::kPlayerCount;
+    std::vector<int> reference(total * seats);
+    std::vector<int> scalar(total * seats);
+    std::vector<int> batched(total * seats);
+
+    // 기준: 벽을 실제로 두고 Board의 거리 맵을 읽는다
+    auto start = std::chrono::steady_clock::now();
+    std::size_t offset = 0;
+    for (std::size_t p = 0; p < states.size(); ++p) {
+        GameState& state = states[p];
+        for (const Move& wall : walls[p]) {
+            state.makeMove(wall);
+            for (std::size_t seat = 0; seat < seats; ++seat) {
+                reference[offset++] = state.board().distanceToGoal(state.pawnCell(seat), state.goalOf(seat));
+            }
+            state.unmakeMove(wall);
+        }
+    }
+    const double referenceSeconds = secondsSince(start);
+
+    // 질의는 미리 만들어 두고 커널만 잰다
+    std::vector<PathQuery> queries;
+    queries.reserve(total * seats);
+    for (std::size_t p = 0; p < states.size(); ++p) {
+        const GameState& state = states[p];
+        for (const Move& wall : walls[p]) {
+            std::array<CellSet, Board::kDirectionCount> open = state.board().openEdges();
+            Board::closeWallEdges(Board::wallSlotPosition(wall.wallSlot()),
+                                  Board::isHorizontalSlot(wall.wallSlot()), open);
+            for (std::size_t seat = 0; seat < seats; ++seat) {
+                queries.push_back(PathQuery{open, CellSet::single(state.pawnCell(seat)),
+                                            Board::goalMask(state.goalOf(seat))});
+            }
+        }
+    }
+    auto runKernel = [&](Kernel kernel, std::vector<int>& out) {
+        const auto begin = std::chrono::steady_clock::now();
+        kernel(queries.data(), static_cast<int>(queries.size()), out.data());
+        return secondsSince(begin);
+    };
+    const double scalarSeconds = runKernel(shortestPathsScalar, scalar);
+    const double batchedSeconds = runKernel(activeKernel(), batched);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        mismatches += reference[i] != scalar[i] || reference[i] != batched[i];
+    }
+
+    auto rate = [](std::size_t count, double seconds) {
+        return static_cast<std::uint64_t>(count / std::max(seconds, 1e-9));
+    };
+    std::cout << states.size() << " positions, " << total << " wall candidates, " << total * seats
+              << " queries\n"
+              << "make/unmake + distance maps: " << rate(total, referenceSeconds) << " walls/s\n"
+              << "scalar kernel: " << rate(total, scalarSeconds) << " walls/s\n"
+              << batchKernelName() << " kernel: " << rate(total, batchedSeconds) << " walls/s, x"
+              << scalarSeconds / std::max(batchedSeconds, 1e-9) << " over scalar\n";
+    if (mismatches) {
+        std::cout << mismatches << " mismatching distances\n";
+        return 1;
+    }
+    std::cout << "all distances match\n";
+    return 0;
+}
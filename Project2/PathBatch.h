@@ -0,0 +1,39 @@
+#pragma once
+#ifndef PATHBATCH_HPP
+#define PATHBATCH_HPP
+
+#include <array>
+
+#include "Board.h"
+#include "CellSet.h"
+#include "GameState.h"
+#include "Move.h"
+
+// 여러 보드의 최단 거리를 한꺼번에 구하는 BFS 커널 (9x9).
+//
+// 질의 하나는 (방향별 열린 변, 출발 셀, 목표 셀)이다. AVX2가 있으면 질의 4개를 256비트 레지스터의
+// 64비트 레인 4개에 나눠 싣고 같은 시프트와 마스크로 한 층씩 함께 넓힌다. CellSet의 아래/위 64비트를
+// 레지스터 두 개에 따로 두므로 레지스터 한 쌍이 보드 4개다. AVX2가 없는 CPU나 x86이 아닌 곳에서는
+// 같은 일을 스칼라로 한다. 어느 쪽을 쓸지는 처음 부를 때 CPU를 보고 정한다.
+struct PathQuery {
+    std::array<CellSet, Board::kDirectionCount> open;  // Board::openEdges() 모양
+    CellSet start;
+    CellSet goal;
+};
+
+// distances[i]는 queries[i]의 출발에서 목표까지 최단 거리 (닿지 않으면 Board::kUnreachable)
+void batchShortestPaths(const PathQuery* queries, int count, int* distances);
+// 늘 스칼라로 돈다 (비교와 측정용)
+void batchShortestPathsScalar(const PathQuery* queries, int count, int* distances);
+// batchShortestPaths가 쓰는 구현 ("avx2" 또는 "scalar")
+const char* batchKernelName();
+
+// state에 walls의 벽을 하나씩 따로 놓았을 때 좌석별 최단 거리.
+// distances[w * GameState::kPlayerCount + seat]. 벽 하나가 AVX2 한 번(좌석 4개 = 레인 4개)이다.
+void wallCandidateDistances(const GameState& state, const Move* walls, int count, int* distances);
+
+// "project2 path-bench [positions]" 명령. 무작위 국면의 합법 벽마다 좌석별 거리를
+// makeMove + 거리 맵, 스칼라 커널, 선택된 커널로 구해 맞춰 보고 속도를 출력한다.
+int runPathBenchCommand(int argc, char** argv);
+
+#endif  // PATHBATCH_HPP
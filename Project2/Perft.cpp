@@ -0,0 +1,178 @@
+#include "Perft.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Move.h"
+#include "Notation.h"
+
+namespace {
+struct PerftCase {
+    const char* name;
+    const char* position;
+    int depth;
+    std::uint64_t nodes;
+};
+
+// 기준값. 이동 생성 규칙을 바꾸면 다시 계산해서 고친다.
+const PerftCase kPerftCases[] = {
+    {"start", "a5,i5,e1,e9 - 10,10,10,10 1", 1, 131ULL},
+    {"start", "a5,i5,e1,e9 - 10,10,10,10 1", 2, 16677ULL},
+    {"start", "a5,i5,e1,e9 - 10,10,10,10 1", 3, 2062065ULL},
+    {"jumps", "d5,e5,e4,e6 4Dh,4Ev,5Dv 7,9,9,10 1", 3, 1518045ULL},
+    {"red cells", "c4,c2,b3,g7 2Bh,6Fv 5,6,7,8 1", 3, 1801609ULL},
+    {"no walls", "b3,h7,c7,g3 3Ch,3Dv,6Eh,5Fv 0,0,0,0 1", 7, 66865ULL},
+    {"near goal", "h5,b5,e8,e2 7Dv,2Ev 1,0,2,0 1", 3, 43458ULL},
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRate(std::uint64_t nodes, double seconds) {
+    std::cout << "  " << seconds << " s";
+    if (seconds > 0) {
+        std::cout << ", " << static_cast<std::uint64_t>(nodes / seconds) << " nodes/s";
+    }
+    std::cout << '\n';
+}
+
+int runSuite() {
+    int failures = 0;
+    std::uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (const PerftCase& test : kPerftCases) {
+        GameState state;
+        if (!notation::parsePosition(test.position, state)) {
+            std::cout << test.name << ": invalid position \"" << test.position << "\"\n";
+            ++failures;
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::uint64_t nodes = perft(state, test.depth);
+        const double seconds = secondsSince(start);
+        totalNodes += nodes;
+        totalSeconds += seconds;
+
+        const bool ok = nodes == test.nodes;
+        if (!ok) {
+            ++failures;
+        }
+        std::cout << test.name << " depth " << test.depth << ": " << nodes
+                  << (ok ? " ok" : " MISMATCH, expected ");
+        if (!ok) {
+            std::cout << test.nodes;
+        }
+        printRate(nodes, seconds);
+    }
+
+    std::cout << "total " << totalNodes << " nodes";
+    printRate(totalNodes, totalSeconds);
+    if (failures) {
+        std::cout << failures << " perft case(s) failed\n";
+    }
+    return failures ? 1 : 0;
+}
+
+int runDivide(int depth, const std::string& position) {
+    GameState state;
+    if (!notation::parsePosition(position, state)) {
+        std::cout << "Invalid position \"" << position << "\"\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t total = 0;
+    MoveList moves;
+    state.legalMoves(moves);
+    for (const Move& move : moves) {
+        state.makeMove(move);
+        const std::uint64_t nodes = perft(state, depth - 1);
+        state.unmakeMove(move);
+        std::cout << notation::moveName(move) << ": " << nodes << '\n';
+        total += nodes;
+    }
+
+    std::cout << "moves " << moves.size() << ", nodes " << total;
+    printRate(total, secondsSince(start));
+    return 0;
+}
+}  // namespace
+
+template <int N>
+std::uint64_t perft(BasicGameState<N>& state, int depth) {
+    if (depth <= 0 || state.isGameOver()) {
+        return 1;
+    }
+
+    typename BasicGameState<N>::MoveList moves;
+    state.legalMoves(moves);
+    if (depth == 1) {
+        return static_cast<std::uint64_t>(moves.size());
+    }
+    std::uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        state.makeMove(move);
+        nodes += perft(state, depth - 1);
+        state.unmakeMove(move);
+    }
+    return nodes;
+}
+
+template std::uint64_t perft<5>(BasicGameState<5>& state, int depth);
+template std::uint64_t perft<7>(BasicGameState<7>& state, int depth);
+template std::uint64_t perft<9>(BasicGameState<9>& state, int depth);
+template std::uint64_t perft<11>(BasicGameState<11>& state, int depth);
+
+namespace {
+template <int N>
+int runSized(int depth) {
+    BasicGameState<N> state;
+    for (int d = 1; d <= depth; ++d) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::uint64_t nodes = perft(state, d);
+        std::cout << N << 'x' << N << " depth " << d << ": " << nodes;
+        printRate(nodes, secondsSince(start));
+    }
+    return 0;
+}
+}  // namespace
+
+int runPerftCommand(int argc, char** argv) {
+    if (argc == 0) {
+        return runSuite();
+    }
+
+    if (std::string(argv[0]) == "--size") {
+        const int size = argc == 3 ? std::atoi(argv[1]) : 0;
+        const int depth = argc == 3 ? std::atoi(argv[2]) : 0;
+        if (depth >= 1) {
+            switch (size) {
+                case 5: return runSized<5>(depth);
+                case 7: return runSized<7>(depth);
+                case 9: return runSized<9>(depth);
+                case 11: return runSized<11>(depth);
+                default: break;
+            }
+        }
+        std::cout << "usage: project2 perft --size 5|7|9|11 <depth>\n";
+        return 1;
+    }
+
+    const int depth = std::atoi(argv[0]);
+    if (depth < 1) {
+        std::cout << "usage: project2 perft [depth [position]]\n";
+        return 1;
+    }
+
+    std::string position;
+    for (int i = 1; i < argc; ++i) {
+        if (i > 1) position += ' ';
+        position += argv[i];
+    }
+    return runDivide(depth, position.empty() ? notation::kStartPosition : position);
+}
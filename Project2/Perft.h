@@ -0,0 +1,22 @@
+#pragma once
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include <cstdint>
+
+#include "GameState.h"
+
+// depth 수 뒤의 말단 국면 수. 이동 생성과 apply/undo 회귀 검사에 쓴다.
+// 게임이 끝난 국면은 그 자리에서 말단으로 친다 (더 두지 않는다).
+// 보드 크기 5, 7, 9, 11에 대해 인스턴스화돼 있다.
+template <int N>
+std::uint64_t perft(BasicGameState<N>& state, int depth);
+
+// "project2 perft ..." 명령.
+//   perft                 기준값 모음을 돌려 노드 수와 노드/초를 확인한다
+//   perft <depth> [국면]  첫 수별 노드 수(divide)와 합계를 출력한다
+//   perft --size <n> <depth>  n x n 보드 시작 국면에서 깊이 1..depth 노드 수를 출력한다
+// 기준값과 다르면 1을 돌려준다.
+int runPerftCommand(int argc, char** argv);
+
+#endif  // PERFT_HPP
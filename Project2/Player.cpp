@@ -56,12 +56,14 @@ int directionToColOffset(char direction) {
 }
 }  // namespace
 
-Player::Player(const std::string& name, const Position& startPosition, int totalWalls)
+template <int N>
+BasicPlayer<N>::BasicPlayer(const std::string& name, const Position& startPosition, int totalWalls)
     : name_(name),
       position_(startPosition),
       wallsRemaining_(totalWalls) {}
 
-Position Player::previewMove(char direction) const {
+template <int N>
+Position BasicPlayer<N>::previewMove(char direction) const {
     direction = static_cast<char>(std::tolower(static_cast<unsigned char>(direction)));
     Position target = position_;
     if (!isValidDirection(direction)) {
@@ -73,62 +75,33 @@ Position Player::previewMove(char direction) const {
     return target;
 }
 
-void Player::move(char direction, int steps) {
-    direction = static_cast<char>(std::tolower(static_cast<unsigned char>(direction)));
-    if (!isValidDirection(direction)) {
-        cout << "Invalid move input for " << name_ << ". isValidDirection\n";
-        return;
-    }
-
-    int rowOffset = directionToRowOffset(direction) * steps;
-    int colOffset = directionToColOffset(direction) * steps;
-    int newRow = position_.row + rowOffset;
-    int newCol = position_.col + colOffset;
-
-    if (!isWithinBoard(newRow, newCol)) {
-        std::cout << name_ << " cannot move outside the board bounds.\n";
-        return;
-    }
-
-    position_.row = newRow;
-    position_.col = newCol;
-}
-
-void Player::showStatus() const {
+template <int N>
+void BasicPlayer<N>::showStatus() const {
     std::cout << name_ << " - Position: (" << position_.row << ", " << position_.col
               << "), Walls left: " << wallsRemaining_ << '\n';
 }
 
-const std::string& Player::getName() const {
+template <int N>
+const std::string& BasicPlayer<N>::getName() const {
     return name_;
 }
 
-Position Player::getPosition() const {
+template <int N>
+Position BasicPlayer<N>::getPosition() const {
     return position_;
 }
 
-int Player::getWallsRemaining() const {
+template <int N>
+int BasicPlayer<N>::getWallsRemaining() const {
     return wallsRemaining_;
 }
 
-bool Player::hasWallsRemaining() const {
+template <int N>
+bool BasicPlayer<N>::hasWallsRemaining() const {
     return wallsRemaining_ > 0;
 }
 
-bool Player::placeWall() {
-    if (wallsRemaining_ == 0) {
-        std::cout << name_ << " has no walls left to place.\n";
-        return false;
-    }
-
-    --wallsRemaining_;
-    return true;
-}
-
-void Player::setPosition(const Position& position) {
-    position_ = position;
-}
-
-bool Player::isWithinBoard(int row, int col) const {
-    return row >= 0 && row < kBoardSize && col >= 0 && col < kBoardSize;
-}
+template class BasicPlayer<5>;
+template class BasicPlayer<7>;
+template class BasicPlayer<9>;
+template class BasicPlayer<11>;
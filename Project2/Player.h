@@ -6,12 +6,14 @@
 
 #include "Position.h"
 
-class Player {
+// 화면 표시용 좌석 정보. 규칙과 상태는 GameState가 가지고, 여기서는 값을 보여 주기만 한다.
+// N은 다른 보드 크기별 타입과 짝을 맞추려고 둔다.
+template <int N>
+class BasicPlayer {
 public:
-    Player(const std::string& name, const Position& startPosition, int totalWalls = 10);
+    BasicPlayer(const std::string& name, const Position& startPosition, int totalWalls = 10);
 
     Position previewMove(char direction) const;
-    void move(char direction, int steps = 1);
     void showStatus() const;
 
     const std::string& getName() const;
@@ -19,17 +21,12 @@ public:
     int getWallsRemaining() const;
     bool hasWallsRemaining() const;
 
-    bool placeWall();
-    void setPosition(const Position& position);
-
 private:
-    static constexpr int kBoardSize = 9;
-
     std::string name_;
     Position position_;
     int wallsRemaining_;
-
-    bool isWithinBoard(int row, int col) const;
 };
 
+using Player = BasicPlayer<9>;
+
 #endif  // PLAYER_HPP
@@ -0,0 +1,486 @@
+#include "Search.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Notation.h"
+#include "PathBatch.h"
+
+namespace {
+// 평가 가중치. 거리 한 칸이 벽 몇 개보다 무겁다.
+constexpr int kClosestOpponentWeight = 100;
+constexpr int kOpponentSumWeight = 20;
+constexpr int kWallWeight = 15;
+
+// 수 정렬 점수 구간
+constexpr int kFirstMoveScore = 1 << 30;
+constexpr int kAdvanceScore = 1 << 24;
+constexpr int kKillerScore = 1 << 20;
+// 벽이 evaluate의 거리 항을 차례인 쪽에 유리하게 kOpponentSumWeight만큼 바꿀 때마다. 이득 4가 폰 한 칸 전진과 같다.
+constexpr int kWallGainScore = 1 << 22;
+constexpr int kMaxWallGain = 15;
+// 남은 깊이가 이만큼은 되어야 벽 후보 전부의 거리를 배치 커널로 잰다 (잎 근처에서는 비용이 더 크다)
+constexpr int kWallScoringDepth = 3;
+
+// 시간은 이 노드 수마다 한 번씩만 확인한다
+constexpr std::uint64_t kTimeCheckInterval = 1024;
+
+// paranoid 점수는 탐색을 시작한 좌석 기준이라, 치환표 키에 그 좌석을 섞는다
+const std::uint64_t kRootSeatKeys[GameState::kPlayerCount] = {
+    0x0000000000000000ULL, 0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL
+};
+
+int historyIndex(const Move& move) {
+    return move.isWall() ? Board::kCellCount + move.wallSlot() : move.to;
+}
+
+int distanceOf(const GameState& state, std::size_t seat) {
+    return state.board().distanceToGoal(state.pawnCell(seat), state.goalOf(seat));
+}
+
+// evaluate의 거리 항 (벽 수 항은 어느 벽을 놓아도 같다)
+int distanceScore(const int* distances, std::size_t seat) {
+    const int own = distances[seat];
+    int closest = Board::kUnreachable;
+    int sum = 0;
+    for (std::size_t other = 0; other < GameState::kPlayerCount; ++other) {
+        if (other != seat) {
+            closest = std::min(closest, distances[other]);
+            sum += distances[other];
+        }
+    }
+    const int opponents = GameState::kPlayerCount - 1;
+    return kClosestOpponentWeight * (closest - own) + kOpponentSumWeight * (sum - opponents * own) / opponents;
+}
+
+bool isWinScore(int score) {
+    return score >= AlphaBetaSearch::kWinScore - AlphaBetaSearch::kMaxPly ||
+           score <= -AlphaBetaSearch::kWinScore + AlphaBetaSearch::kMaxPly;
+}
+
+// 승패 점수는 루트가 아니라 그 노드에서의 거리로 저장한다
+int scoreToTable(int score, int ply) {
+    if (score >= AlphaBetaSearch::kWinScore - AlphaBetaSearch::kMaxPly) return score + ply;
+    if (score <= -AlphaBetaSearch::kWinScore + AlphaBetaSearch::kMaxPly) return score - ply;
+    return score;
+}
+
+int scoreFromTable(int score, int ply) {
+    if (score >= AlphaBetaSearch::kWinScore - AlphaBetaSearch::kMaxPly) return score - ply;
+    if (score <= -AlphaBetaSearch::kWinScore + AlphaBetaSearch::kMaxPly) return score + ply;
+    return score;
+}
+
+// bench에 쓰는 국면들
+const char* const kBenchPositions[] = {
+    "a5,i5,e1,e9 - 10,10,10,10 1",
+    "d5,e5,e4,e6 4Dh,4Ev,5Dv 7,9,9,10 1",
+    "c4,c2,b3,g7 2Bh,6Fv 5,6,7,8 1",
+    "h5,b5,e8,e2 7Dv,2Ev 1,0,2,0 1",
+};
+}  // namespace
+
+constexpr int AlphaBetaSearch::kMaxPly;
+constexpr int AlphaBetaSearch::kWinScore;
+constexpr int AlphaBetaSearch::kInfinity;
+
+AlphaBetaSearch::AlphaBetaSearch(std::size_t hashMegabytes)
+    : table_(hashMegabytes), network_(nullptr), stop_(false) {
+}
+
+SearchResult AlphaBetaSearch::search(const GameState& state, const SearchLimits& limits) {
+    limits_ = limits;
+    start_ = std::chrono::steady_clock::now();
+    deadline_ = start_ + std::chrono::milliseconds(limits.timeMillis);
+    stop_.store(false);
+
+    // 풀이기에 쓴 시간도 이번 수의 시간에서 나간다 (풀이기는 시간과 노드의 절반까지만 쓴다)
+    EndgameSolver::Result solved;
+    if (endgame_.solve(state, solved, EndgameSolver::Budget::forMove(limits.timeMillis, limits.maxNodes))) {
+        SearchResult result;
+        result.bestMove = solved.move;
+        result.hasMove = true;
+        result.score = kWinScore - solved.plies;
+        result.depth = solved.plies;
+        result.nodes = solved.nodes;
+        result.seconds = solved.seconds;
+        return result;
+    }
+
+    table_.newSearch();
+
+    // Worker는 killer/history 표 때문에 커서 힙에 둔다
+    const int threadCount = std::max(1, limits.threads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(new Worker(*this, state, i == 0));
+    }
+
+    // 보조 스레드는 시작 깊이를 엇갈려 서로 다른 부분을 먼저 채운다
+    std::vector<SearchResult> helperResults(threadCount);
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i) {
+        helpers.emplace_back([&workers, &helperResults, i]() {
+            workers[i]->iterate(1 + i % 2, helperResults[i]);
+        });
+    }
+
+    SearchResult result;
+    workers[0]->iterate(1, result);
+    stop_.store(true);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = 0;
+    for (const auto& worker : workers) {
+        result.nodes += worker->nodes();
+        result.table += worker->tableStats();
+    }
+    result.hashUsagePermille = table_.usagePermille();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    return result;
+}
+
+bool AlphaBetaSearch::timeIsUp() const {
+    return limits_.timeMillis > 0 && std::chrono::steady_clock::now() >= deadline_;
+}
+
+AlphaBetaSearch::Worker::Worker(AlphaBetaSearch& owner, const GameState& state, bool reportsTime)
+    : owner_(owner), state_(state), rootSeat_(state.currentTurn()),
+      reportsTime_(reportsTime), nodes_(0) {
+    if (owner_.network_) {
+        accumulator_.refresh(*owner_.network_, state_, rootSeat_);
+    }
+    for (auto& killers : killers_) {
+        killers[0] = killers[1] = Move();
+    }
+    for (auto& seat : history_) {
+        std::fill(std::begin(seat), std::end(seat), 0);
+    }
+}
+
+void AlphaBetaSearch::Worker::iterate(int startDepth, SearchResult& result) {
+    MoveList rootMoves;
+    state_.legalMoves(rootMoves);
+    if (rootMoves.empty()) {
+        return;
+    }
+    result.bestMove = rootMoves[0];
+    result.hasMove = true;
+
+    const int maxDepth = std::min(owner_.limits_.maxDepth, kMaxPly - 1);
+    for (int depth = std::min(startDepth, maxDepth); depth <= maxDepth; ++depth) {
+        orderMoves(rootMoves, 0, depth, result.bestMove);
+
+        int alpha = -kInfinity;
+        Move best = rootMoves[0];
+        bool searchedAny = false;
+        for (const Move& move : rootMoves) {
+            makeMove(move);
+            const int score = alphaBeta(depth - 1, 1, alpha, kInfinity);
+            unmakeMove(move);
+            if (stopped()) {
+                break;
+            }
+            searchedAny = true;
+            if (score > alpha) {
+                alpha = score;
+                best = move;
+            }
+        }
+
+        // 중단된 반복이라도 첫 수(직전 최선수)를 끝까지 봤다면 그 안에서 찾은 최선수는 믿을 만하다
+        if (searchedAny) {
+            result.bestMove = best;
+            result.score = alpha;
+        }
+        if (stopped()) {
+            break;
+        }
+        result.depth = depth;
+
+        TranspositionTable::Entry entry;
+        entry.move = best;
+        entry.score = scoreToTable(alpha, 0);
+        entry.depth = depth;
+        entry.bound = TranspositionTable::Bound::Exact;
+        owner_.table_.store(tableKey(), entry, tableStats_);
+
+        if (isWinScore(alpha)) {
+            break;
+        }
+        // 다음 반복은 보통 몇 배 더 걸리므로 시간의 절반을 넘겼으면 멈춘다
+        if (reportsTime_ && owner_.limits_.timeMillis > 0 &&
+            std::chrono::steady_clock::now() - owner_.start_ > (owner_.deadline_ - owner_.start_) / 2) {
+            break;
+        }
+    }
+}
+
+int AlphaBetaSearch::Worker::alphaBeta(int depth, int ply, int alpha, int beta) {
+    ++nodes_;
+    if (stopped()) {
+        return 0;
+    }
+
+    if (state_.isGameOver()) {
+        return static_cast<std::size_t>(state_.winner()) == rootSeat_ ? kWinScore - ply
+                                                                       : -kWinScore + ply;
+    }
+    // 같은 국면이 다시 나오면 더 파도 새로운 것이 없다. 이번 탐색에서 둔 ply수만 돌아본다.
+    if (depth <= 0 || ply >= kMaxPly - 1 || state_.repetitionCount(ply) > 0) {
+        return staticEvaluation();
+    }
+
+    const std::uint64_t key = tableKey();
+    TranspositionTable::Entry entry;
+    Move tableMove;
+    if (owner_.table_.probe(key, entry, tableStats_)) {
+        tableMove = entry.move;
+        if (entry.depth >= depth) {
+            const int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == TranspositionTable::Bound::Exact ||
+                (entry.bound == TranspositionTable::Bound::Lower && score >= beta) ||
+                (entry.bound == TranspositionTable::Bound::Upper && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    MoveList moves;
+    state_.legalMoves(moves);
+    if (moves.empty()) {
+        return staticEvaluation();
+    }
+    orderMoves(moves, ply, depth, tableMove);
+
+    const bool maximizing = state_.currentTurn() == rootSeat_;
+    const int originalAlpha = alpha;
+    const int originalBeta = beta;
+    int best = maximizing ? -kInfinity : kInfinity;
+    Move bestMove = moves[0];
+    for (const Move& move : moves) {
+        makeMove(move);
+        const int score = alphaBeta(depth - 1, ply + 1, alpha, beta);
+        unmakeMove(move);
+        if (stopped()) {
+            return 0;
+        }
+
+        if (maximizing ? score > best : score < best) {
+            best = score;
+            bestMove = move;
+        }
+        if (maximizing) {
+            alpha = std::max(alpha, best);
+        } else {
+            beta = std::min(beta, best);
+        }
+        if (alpha >= beta) {
+            rememberCutoff(move, ply, depth);
+            break;
+        }
+    }
+
+    entry.move = bestMove;
+    entry.score = scoreToTable(best, ply);
+    entry.depth = depth;
+    entry.bound = best <= originalAlpha ? TranspositionTable::Bound::Upper
+                : best >= originalBeta  ? TranspositionTable::Bound::Lower
+                                        : TranspositionTable::Bound::Exact;
+    owner_.table_.store(key, entry, tableStats_);
+    return best;
+}
+
+int AlphaBetaSearch::evaluate(const GameState& state, std::size_t seat) {
+    const int own = distanceOf(state, seat);
+    int closest = Board::kUnreachable;
+    int sum = 0;
+    int opponentWalls = 0;
+    for (std::size_t other = 0; other < state.playerCount(); ++other) {
+        if (other == seat) {
+            continue;
+        }
+        const int distance = distanceOf(state, other);
+        closest = std::min(closest, distance);
+        sum += distance;
+        opponentWalls = std::max(opponentWalls, state.wallsRemaining(other));
+    }
+
+    const int opponents = static_cast<int>(state.playerCount()) - 1;
+    return kClosestOpponentWeight * (closest - own) +
+           kOpponentSumWeight * (sum - opponents * own) / opponents +
+           kWallWeight * (state.wallsRemaining(seat) - opponentWalls);
+}
+
+void AlphaBetaSearch::Worker::orderMoves(MoveList& moves, int ply, int depth, const Move& first) const {
+    int scores[MoveList::kCapacity];
+    for (int i = 0; i < moves.size(); ++i) {
+        scores[i] = moves[i] == first ? kFirstMoveScore : moveOrderScore(moves[i], ply);
+    }
+    if (depth >= kWallScoringDepth) {
+        addWallGains(moves, scores);
+    }
+
+    // 삽입 정렬. 목록이 짧고 대부분 벽(같은 구간)이라 충분하다.
+    for (int i = 1; i < moves.size(); ++i) {
+        const Move move = moves[i];
+        const int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            --j;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+int AlphaBetaSearch::Worker::moveOrderScore(const Move& move, int ply) const {
+    const std::size_t seat = state_.currentTurn();
+    int score = history_[seat][historyIndex(move)];
+
+    if (move == killers_[ply][0] || move == killers_[ply][1]) {
+        score += kKillerScore;
+    }
+    if (!move.isWall()) {
+        const GoalType goal = state_.goalOf(seat);
+        const int before = state_.board().distanceToGoal(Board::cellPosition(move.from), goal);
+        const int after = state_.board().distanceToGoal(Board::cellPosition(move.to), goal);
+        if (after < before) {
+            score += kAdvanceScore * (before - after);
+        }
+    }
+    return score;
+}
+
+// 벽 후보마다 놓은 뒤의 좌석별 거리를 배치 커널로 한꺼번에 재서, 거리 평가를 가장 많이 바꾸는 벽을 앞으로 올린다
+void AlphaBetaSearch::Worker::addWallGains(const MoveList& moves, int* scores) const {
+    Move walls[MoveList::kCapacity];
+    int indices[MoveList::kCapacity];
+    int count = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+        if (moves[i].isWall()) {
+            walls[count] = moves[i];
+            indices[count] = i;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+
+    int distances[MoveList::kCapacity * GameState::kPlayerCount];
+    wallCandidateDistances(state_, walls, count, distances);
+    int before[GameState::kPlayerCount];
+    for (std::size_t seat = 0; seat < GameState::kPlayerCount; ++seat) {
+        before[seat] = distanceOf(state_, seat);
+    }
+
+    // paranoid: 루트 차례면 루트 기준 거리 평가를 올리는 벽, 상대 차례면 내리는 벽이 좋다
+    const int sign = state_.currentTurn() == rootSeat_ ? 1 : -1;
+    const int current = distanceScore(before, rootSeat_);
+    for (int w = 0; w < count; ++w) {
+        const int gain = sign * (distanceScore(distances + w * GameState::kPlayerCount, rootSeat_) - current) /
+                         kOpponentSumWeight;
+        if (gain > 0 && scores[indices[w]] != kFirstMoveScore) {
+            scores[indices[w]] += kWallGainScore * std::min(gain, kMaxWallGain);
+        }
+    }
+}
+
+void AlphaBetaSearch::Worker::rememberCutoff(const Move& move, int ply, int depth) {
+    if (killers_[ply][0] != move) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = move;
+    }
+    int& history = history_[state_.currentTurn()][historyIndex(move)];
+    history = std::min(history + depth * depth, kKillerScore - 1);
+}
+
+void AlphaBetaSearch::Worker::makeMove(const Move& move) {
+    if (owner_.network_) {
+        accumulator_.makeMove(state_, move);
+    }
+    state_.makeMove(move);
+}
+
+void AlphaBetaSearch::Worker::unmakeMove(const Move& move) {
+    state_.unmakeMove(move);
+    if (owner_.network_) {
+        accumulator_.unmakeMove(state_, move);
+    }
+}
+
+int AlphaBetaSearch::Worker::staticEvaluation() const {
+    return owner_.network_ ? owner_.network_->evaluate(accumulator_) : evaluate(state_, rootSeat_);
+}
+
+bool AlphaBetaSearch::Worker::stopped() {
+    if (owner_.stop_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if ((nodes_ % kTimeCheckInterval) == 0 &&
+        ((owner_.limits_.maxNodes > 0 && nodes_ >= owner_.limits_.maxNodes) || owner_.timeIsUp())) {
+        owner_.stop_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+std::uint64_t AlphaBetaSearch::Worker::tableKey() const {
+    return state_.hash() ^ kRootSeatKeys[rootSeat_];
+}
+
+int runBenchCommand(int argc, char** argv) {
+    SearchLimits limits;
+    std::size_t hashMegabytes = 16;
+    if (argc > 0) limits.timeMillis = std::atoi(argv[0]);
+    if (argc > 1) limits.threads = std::atoi(argv[1]);
+    if (argc > 2) hashMegabytes = static_cast<std::size_t>(std::atoi(argv[2]));
+    if (limits.timeMillis <= 0 || limits.threads <= 0 || hashMegabytes == 0) {
+        std::cout << "usage: project2 bench [milliseconds per position [threads [hash MB]]]\n";
+        return 1;
+    }
+
+    AlphaBetaSearch search(hashMegabytes);
+    std::uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    TranspositionTable::Stats totalTable;
+    for (const char* position : kBenchPositions) {
+        GameState state;
+        if (!notation::parsePosition(position, state)) {
+            std::cout << "Invalid position \"" << position << "\"\n";
+            return 1;
+        }
+
+        search.table().clear();
+        const SearchResult result = search.search(state, limits);
+        totalNodes += result.nodes;
+        totalSeconds += result.seconds;
+        totalTable += result.table;
+        std::cout << position << ": " << notation::moveName(result.bestMove)
+                  << " score " << result.score << " depth " << result.depth
+                  << " nodes " << result.nodes << ' '
+                  << static_cast<std::uint64_t>(result.nodes / std::max(result.seconds, 1e-9))
+                  << " nodes/s, hash full " << result.hashUsagePermille << "/1000\n";
+    }
+
+    const double probes = static_cast<double>(std::max<std::uint64_t>(totalTable.probes, 1));
+    std::cout << "total " << totalNodes << " nodes, "
+              << static_cast<std::uint64_t>(totalNodes / std::max(totalSeconds, 1e-9))
+              << " nodes/s\n"
+              << "hash " << search.table().megabytes() << " MB (" << search.table().entryCount()
+              << " entries): probes " << totalTable.probes
+              << ", hit rate " << 100.0 * totalTable.hits / probes << "%"
+              << ", stores " << totalTable.stores
+              << ", overwrites " << totalTable.overwrites << '\n';
+    return 0;
+}
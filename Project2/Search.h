@@ -0,0 +1,109 @@
+#pragma once
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Endgame.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Nnue.h"
+#include "TranspositionTable.h"
+
+struct SearchLimits {
+    int timeMillis = 1000;      // 한 수에 쓸 시간 (0이면 제한 없음)
+    int maxDepth = 64;          // 반복 심화 최대 깊이 (수 단위, 4수가 한 바퀴)
+    std::uint64_t maxNodes = 0; // 0이면 제한 없음 (스레드마다)
+    int threads = 1;            // 치환표를 공유하는 탐색 스레드 수
+};
+
+struct SearchResult {
+    Move bestMove;
+    bool hasMove = false;
+    int score = 0;              // 탐색한 좌석 기준 점수
+    int depth = 0;              // 끝까지 마친 반복 심화 깊이
+    std::uint64_t nodes = 0;    // 모든 스레드 합
+    double seconds = 0;
+    TranspositionTable::Stats table;
+    int hashUsagePermille = 0;
+};
+
+// 4인 게임용 paranoid alpha-beta. 차례인 좌석이 최대화하고 나머지 셋은 한 편이 되어
+// 그 좌석 점수를 최소화한다고 가정한다. 반복 심화, 시간 제한, 수 정렬
+// (치환표/직전 반복의 최선수, 거리를 줄이는 폰 이동, killer, history)을 쓴다.
+// 스레드가 여럿이면 같은 국면을 각자 탐색하면서 치환표만 공유한다 (lazy SMP).
+// 벽이 모두 떨어진 국면에서 EndgameSolver가 강제 승리를 찾으면 탐색 없이 그 수를 낸다.
+// setNetwork로 망을 주면 잎을 NNUE로 평가하고, 루트 좌석 누산기를 수마다 증분 갱신한다.
+class AlphaBetaSearch {
+public:
+    static constexpr int kMaxPly = 64;
+    static constexpr int kWinScore = 100000;
+    static constexpr int kInfinity = kWinScore + 1000;
+
+    explicit AlphaBetaSearch(std::size_t hashMegabytes = 16);
+
+    SearchResult search(const GameState& state, const SearchLimits& limits);
+
+    TranspositionTable& table() { return table_; }
+    // 잎 평가를 신경망으로 한다 (nullptr이면 evaluate). 망은 탐색보다 오래 살아 있어야 한다.
+    void setNetwork(const nnue::Network* network) { network_ = network; }
+
+    // seat 기준 정적 평가. 벽만 고려한 목표까지 거리와 남은 벽 수를 본다.
+    static int evaluate(const GameState& state, std::size_t seat);
+
+private:
+    // 스레드 하나의 탐색 상태
+    class Worker {
+    public:
+        Worker(AlphaBetaSearch& owner, const GameState& state, bool reportsTime);
+
+        // startDepth부터 반복 심화. 끝까지 마친 반복의 결과를 result에 남긴다.
+        void iterate(int startDepth, SearchResult& result);
+
+        std::uint64_t nodes() const { return nodes_; }
+        const TranspositionTable::Stats& tableStats() const { return tableStats_; }
+
+    private:
+        int alphaBeta(int depth, int ply, int alpha, int beta);
+        void orderMoves(MoveList& moves, int ply, int depth, const Move& first) const;
+        int moveOrderScore(const Move& move, int ply) const;
+        void addWallGains(const MoveList& moves, int* scores) const;
+        void rememberCutoff(const Move& move, int ply, int depth);
+        bool stopped();
+        std::uint64_t tableKey() const;
+        // 국면과 (망을 쓰면) 루트 좌석 누산기를 함께 움직인다
+        void makeMove(const Move& move);
+        void unmakeMove(const Move& move);
+        int staticEvaluation() const;
+
+        AlphaBetaSearch& owner_;
+        GameState state_;
+        std::size_t rootSeat_;
+        bool reportsTime_;
+        std::uint64_t nodes_;
+        TranspositionTable::Stats tableStats_;
+        nnue::Accumulator accumulator_;
+
+        Move killers_[kMaxPly][2];
+        int history_[GameState::kPlayerCount][Board::kCellCount + Board::kWallSlotCount];
+    };
+
+    bool timeIsUp() const;
+
+    TranspositionTable table_;
+    EndgameSolver endgame_;
+    const nnue::Network* network_;
+    SearchLimits limits_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<bool> stop_;
+};
+
+// "project2 bench [ms [threads [hashMB]]]" 명령. 몇 개 국면에서 정해진 시간 동안 탐색해
+// 도달 깊이, 노드/초, 치환표 적중률을 출력한다.
+int runBenchCommand(int argc, char** argv);
+
+#endif  // SEARCH_HPP
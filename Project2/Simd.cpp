@@ -0,0 +1,29 @@
+#include "Simd.h"
+
+#if defined(_MSC_VER) && defined(SIMD_X86)
+#include <intrin.h>
+#endif
+
+bool cpuHasAvx2() {
+#if !defined(SIMD_X86)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // 운영체제가 YMM 레지스터를 저장해 주는지도 봐야 한다
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
@@ -0,0 +1,21 @@
+#pragma once
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+// SIMD 커널 공통. SIMD_X86이면 x86 내장 함수를 쓸 수 있고, AVX2 커널 함수에는 SIMD_AVX2를 붙인다
+// (GCC/Clang은 함수 단위로 AVX2를 켜고, MSVC는 붙일 것이 없다). 어느 커널을 쓸지는 실행 중에
+// cpuHasAvx2()로 한 번 정하므로 AVX2가 없는 CPU에서도 같은 실행 파일이 돈다.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define SIMD_AVX2
+#else
+#define SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// CPU와 운영체제가 모두 AVX2를 지원하는지 (x86이 아니면 false)
+bool cpuHasAvx2();
+
+#endif  // SIMD_HPP
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : pending_(0), queued_(0), nextQueue_(0), stopping_(false) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    for (int i = 0; i < threads; ++i) {
+        queues_.emplace_back(new Queue);
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i]() { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        // 큐에 넣는 것과 queued_를 올리는 것을 stateMutex_ 안에서 함께 해야 기다리려던 워커가 알림을 놓치지 않는다
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        ++pending_;
+        const std::size_t target = nextQueue_;
+        nextQueue_ = (nextQueue_ + 1) % queues_.size();
+        {
+            std::lock_guard<std::mutex> queueLock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        ++queued_;
+    }
+    workAvailable_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    allDone_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+void ThreadPool::run(int worker) {
+    while (true) {
+        Task task;
+        if (popLocal(worker, task) || steal(worker, task)) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                --queued_;
+            }
+            task(worker);
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            if (--pending_ == 0) {
+                allDone_.notify_all();
+            }
+            continue;
+        }
+
+        // 어느 큐에도 없으면 큐에 든 작업이 생기거나 종료할 때까지 기다린다
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        workAvailable_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popLocal(int worker, Task& task) {
+    Queue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int thief, Task& task) {
+    const int count = static_cast<int>(queues_.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Queue& queue = *queues_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 작업 훔치기(work-stealing) 스레드 풀.
+// 워커마다 자기 큐가 있어 제 큐 뒤에서 꺼내고, 비면 다른 워커 큐 앞에서 훔친다.
+// 작업은 자기를 실행하는 워커 번호를 받으므로 워커별 자원(탐색 엔진 등)을 잠금 없이 쓸 수 있다.
+class ThreadPool {
+public:
+    using Task = std::function<void(int worker)>;
+
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()); }
+
+    // 작업을 워커 큐들에 돌아가며 넣는다
+    void submit(Task task);
+    // 넣은 작업이 모두 끝날 때까지 기다린다
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int worker);
+    bool popLocal(int worker, Task& task);
+    bool steal(int thief, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    std::size_t pending_;   // 넣었지만 아직 끝나지 않은 작업 (실행 중 포함)
+    std::size_t queued_;    // 아직 큐에 있는 작업. 워커는 이것이 0이 아니면 기다리지 않는다.
+    std::size_t nextQueue_;
+    bool stopping_;
+};
+
+#endif  // THREADPOOL_HPP
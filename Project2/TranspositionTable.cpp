@@ -0,0 +1,195 @@
+#include "TranspositionTable.h"
+
+#include <new>
+
+namespace {
+// data 비트 배치
+//   0      수 종류 (1 = 벽)
+//   1..7   출발 셀
+//   8..14  도착 셀 / 벽 슬롯
+//   15..17 자리바꾸기 좌석 (7 = 없음)
+//   18..37 점수 + kScoreLimit
+//   38..44 깊이
+//   45..46 Bound
+//   47..52 세대
+constexpr int kScoreShift = 18;
+constexpr int kDepthShift = 38;
+constexpr int kBoundShift = 45;
+constexpr int kGenerationShift = 47;
+constexpr unsigned kGenerationMask = 63;
+constexpr std::uint64_t kNoSwapBits = 7;
+
+// 세대 차이 하나를 깊이 몇으로 칠지 (오래된 항목이 먼저 밀려난다)
+constexpr int kAgeWeight = 8;
+}  // namespace
+
+constexpr int TranspositionTable::kMaxDepth;
+constexpr int TranspositionTable::kScoreLimit;
+constexpr int TranspositionTable::kClusterSize;
+
+static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t),
+              "transposition table slots must be two plain 64-bit words");
+
+TranspositionTable::Stats& TranspositionTable::Stats::operator+=(const Stats& other) {
+    probes += other.probes;
+    hits += other.hits;
+    stores += other.stores;
+    overwrites += other.overwrites;
+    return *this;
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes)
+    : clusters_(nullptr), clusterCount_(0), megabytes_(0), generation_(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    if (megabytes == 0) {
+        megabytes = 1;
+    }
+
+    // 클러스터 수는 2의 거듭제곱으로 내린다 (인덱스를 마스크로 구하려고)
+    const std::size_t wanted = megabytes * 1024 * 1024 / sizeof(Cluster);
+    std::size_t count = 1;
+    while (count * 2 <= wanted) {
+        count *= 2;
+    }
+
+    memory_.reset(new unsigned char[count * sizeof(Cluster) + alignof(Cluster)]);
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory_.get());
+    const std::uintptr_t aligned = (address + alignof(Cluster) - 1) & ~std::uintptr_t{alignof(Cluster) - 1};
+    clusters_ = reinterpret_cast<Cluster*>(aligned);
+    for (std::size_t i = 0; i < count; ++i) {
+        new (clusters_ + i) Cluster;
+    }
+    clusterCount_ = count;
+    megabytes_ = megabytes;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < clusterCount_; ++i) {
+        for (Slot& slot : clusters_[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation_ = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation_ = (generation_ + 1) & kGenerationMask;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry, Stats& stats) const {
+    ++stats.probes;
+    const Cluster& cluster = clusterFor(key);
+    for (const Slot& slot : cluster.slots) {
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            unpack(data, entry);
+            ++stats.hits;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, const Entry& entry, Stats& stats) {
+    Cluster& cluster = clusterFor(key);
+
+    Slot* target = nullptr;
+    int worstValue = 0;
+    bool sameKey = false;
+    for (Slot& slot : cluster.slots) {
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0) {
+            if (!target) {
+                target = &slot;
+                worstValue = -kMaxDepth * kAgeWeight;
+            }
+            continue;
+        }
+        if ((check ^ data) == key) {
+            // 같은 국면: 더 얕은 결과가 깊은 결과를 덮지 않게 한다 (이번 세대 항목일 때만)
+            if (generationOf(data) == generation_ && entry.bound != Bound::Exact &&
+                entry.depth + 2 < depthOf(data)) {
+                return;
+            }
+            target = &slot;
+            sameKey = true;
+            break;
+        }
+
+        const int age = static_cast<int>((generation_ - generationOf(data)) & kGenerationMask);
+        const int value = depthOf(data) - kAgeWeight * age;
+        if (!target || value < worstValue) {
+            target = &slot;
+            worstValue = value;
+        }
+    }
+
+    if (!sameKey && target->data.load(std::memory_order_relaxed) != 0) {
+        ++stats.overwrites;
+    }
+    ++stats.stores;
+
+    const std::uint64_t data = pack(entry, generation_);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::usagePermille() const {
+    const std::size_t sample = clusterCount_ < 250 ? clusterCount_ : 250;
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        for (const Slot& slot : clusters_[i].slots) {
+            const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data != 0 && generationOf(data) == generation_) {
+                ++used;
+            }
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * kClusterSize));
+}
+
+std::uint64_t TranspositionTable::pack(const Entry& entry, unsigned generation) {
+    int score = entry.score;
+    if (score > kScoreLimit) score = kScoreLimit;
+    if (score < -kScoreLimit) score = -kScoreLimit;
+    int depth = entry.depth;
+    if (depth > kMaxDepth) depth = kMaxDepth;
+    if (depth < 0) depth = 0;
+
+    const Move& move = entry.move;
+    const std::uint64_t swap = move.swapWith == Move::kNoSwap ? kNoSwapBits : move.swapWith;
+    return (move.isWall() ? 1ULL : 0ULL) |
+           (std::uint64_t{move.from} << 1) |
+           (std::uint64_t{move.to} << 8) |
+           (swap << 15) |
+           (static_cast<std::uint64_t>(score + kScoreLimit) << kScoreShift) |
+           (static_cast<std::uint64_t>(depth) << kDepthShift) |
+           (static_cast<std::uint64_t>(entry.bound) << kBoundShift) |
+           (static_cast<std::uint64_t>(generation) << kGenerationShift);
+}
+
+void TranspositionTable::unpack(std::uint64_t data, Entry& entry) {
+    const std::uint64_t swap = (data >> 15) & 7;
+    entry.move.type = (data & 1) ? Move::Type::Wall : Move::Type::Pawn;
+    entry.move.from = static_cast<std::uint8_t>((data >> 1) & 0x7F);
+    entry.move.to = static_cast<std::uint8_t>((data >> 8) & 0x7F);
+    entry.move.swapWith = swap == kNoSwapBits ? Move::kNoSwap : static_cast<std::uint8_t>(swap);
+    entry.score = static_cast<int>((data >> kScoreShift) & 0xFFFFF) - kScoreLimit;
+    entry.depth = depthOf(data);
+    entry.bound = static_cast<Bound>((data >> kBoundShift) & 3);
+}
+
+int TranspositionTable::depthOf(std::uint64_t data) {
+    return static_cast<int>((data >> kDepthShift) & 0x7F);
+}
+
+unsigned TranspositionTable::generationOf(std::uint64_t data) {
+    return static_cast<unsigned>((data >> kGenerationShift) & kGenerationMask);
+}
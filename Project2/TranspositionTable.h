@@ -0,0 +1,90 @@
+#pragma once
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Move.h"
+
+// 탐색 스레드들이 잠금 없이 공유하는 고정 크기 치환표.
+//
+// 항목 하나는 64비트 두 개 (key ^ data, data). 읽을 때 key를 다시 XOR해서 맞춰 보므로
+// 다른 스레드가 쓰는 도중의 찢어진 항목은 그냥 없는 것으로 취급된다 (XOR 검증).
+// 항목 네 개가 64바이트 캐시 라인 하나(클러스터)에 들어가고, 해시가 클러스터를 고른다.
+class TranspositionTable {
+public:
+    enum class Bound : std::uint8_t {
+        None,
+        Upper,  // 실제 점수 <= score
+        Lower,  // 실제 점수 >= score
+        Exact
+    };
+
+    struct Entry {
+        Move move;
+        int score = 0;
+        int depth = 0;
+        Bound bound = Bound::None;
+    };
+
+    // 스레드마다 따로 모으고 끝나면 합친다 (공유 카운터 경합을 피하려고)
+    struct Stats {
+        std::uint64_t probes = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t stores = 0;
+        std::uint64_t overwrites = 0;  // 다른 국면이 쓰던 항목을 덮어쓴 횟수 (인덱스 충돌)
+
+        Stats& operator+=(const Stats& other);
+    };
+
+    static constexpr int kMaxDepth = 127;
+    static constexpr int kScoreLimit = (1 << 19) - 1;
+
+    explicit TranspositionTable(std::size_t megabytes = 16);
+
+    // 크기를 바꾸고 비운다. 탐색 중에는 부르지 않는다.
+    void resize(std::size_t megabytes);
+    void clear();
+    // 새 탐색을 시작할 때 부른다. 이전 탐색 항목이 먼저 교체된다.
+    void newSearch();
+
+    bool probe(std::uint64_t key, Entry& entry, Stats& stats) const;
+    void store(std::uint64_t key, const Entry& entry, Stats& stats);
+
+    std::size_t megabytes() const { return megabytes_; }
+    std::size_t entryCount() const { return clusterCount_ * kClusterSize; }
+    // 이번 탐색 세대 항목 비율 (앞쪽 클러스터 표본, 천분율)
+    int usagePermille() const;
+
+private:
+    static constexpr int kClusterSize = 4;
+
+    struct Slot {
+        std::atomic<std::uint64_t> check;  // key ^ data
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(64) Cluster {
+        Slot slots[kClusterSize];
+    };
+
+    static std::uint64_t pack(const Entry& entry, unsigned generation);
+    static void unpack(std::uint64_t data, Entry& entry);
+    static int depthOf(std::uint64_t data);
+    static unsigned generationOf(std::uint64_t data);
+
+    Cluster& clusterFor(std::uint64_t key) const {
+        return clusters_[key & (clusterCount_ - 1)];
+    }
+
+    std::unique_ptr<unsigned char[]> memory_;
+    Cluster* clusters_;
+    std::size_t clusterCount_;
+    std::size_t megabytes_;
+    unsigned generation_;
+};
+
+#endif  // TRANSPOSITIONTABLE_HPP
@@ -0,0 +1,42 @@
+#include "Zobrist.h"
+
+namespace {
+// 고정 시드 splitmix64. 실행마다 같은 키가 나와야 저장한 해시(기보, 데이터셋)를 다시 쓸 수 있다.
+std::uint64_t nextKey(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+}  // namespace
+
+template <int N>
+constexpr int BasicZobrist<N>::kSeatCount;
+template <int N>
+constexpr int BasicZobrist<N>::kMaxWalls;
+
+template <int N>
+BasicZobrist<N>::Keys::Keys() {
+    std::uint64_t state = 0x51A2B3C4D5E6F708ULL + static_cast<std::uint64_t>(N - 9) * 0x9E3779B97F4A7C15ULL;
+    for (auto& seat : pawn) {
+        for (auto& key : seat) {
+            key = nextKey(state);
+        }
+    }
+    for (auto& key : wall) {
+        key = nextKey(state);
+    }
+    for (auto& seat : wallsRemaining) {
+        for (auto& key : seat) {
+            key = nextKey(state);
+        }
+    }
+    for (auto& key : turn) {
+        key = nextKey(state);
+    }
+}
+
+template class BasicZobrist<5>;
+template class BasicZobrist<7>;
+template class BasicZobrist<9>;
+template class BasicZobrist<11>;
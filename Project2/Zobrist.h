@@ -0,0 +1,42 @@
+#pragma once
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+#include "Board.h"
+
+// 국면 해시용 64비트 난수 키. 좌석별 폰 위치, 벽 슬롯, 좌석별 남은 벽 수, 차례에 하나씩.
+// 국면 해시는 해당 키들의 XOR이라 수 하나마다 몇 번의 XOR로 갱신된다.
+// 보드 크기마다 키 표가 따로 있다 (9x9 키는 크기를 템플릿으로 바꾸기 전과 같다).
+template <int N>
+class BasicZobrist {
+public:
+    static constexpr int kSeatCount = 4;
+    static constexpr int kMaxWalls = N + 1;
+
+    static std::uint64_t pawn(int seat, int cell) { return table().pawn[seat][cell]; }
+    static std::uint64_t wall(int slot) { return table().wall[slot]; }
+    static std::uint64_t wallsRemaining(int seat, int count) { return table().wallsRemaining[seat][count]; }
+    static std::uint64_t turn(int seat) { return table().turn[seat]; }
+
+private:
+    struct Keys {
+        Keys();
+
+        std::uint64_t pawn[kSeatCount][BasicBoard<N>::kCellCount];
+        std::uint64_t wall[BasicBoard<N>::kWallSlotCount];
+        std::uint64_t wallsRemaining[kSeatCount][kMaxWalls + 1];
+        std::uint64_t turn[kSeatCount];
+    };
+
+    // 함수 안 정적 객체라 다른 번역 단위의 정적 초기화 순서와 무관하다
+    static const Keys& table() {
+        static const Keys keys;
+        return keys;
+    }
+};
+
+using Zobrist = BasicZobrist<9>;
+
+#endif  // ZOBRIST_HPP
@@ -1,7 +1,140 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "Arena.h"
+#include "Endgame.h"
 #include "Game.h"
+#include "GameArchive.h"
+#include "GameRecord.h"
+#include "Mcts.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
+#include "PathBatch.h"
+#include "Perft.h"
+#include "Search.h"
+
+namespace {
+// project2 [--computer 2,4] [--mcts 3] [--time ms] [--depth n] [--threads n] [--hash MB]
+//          [--render full|skip|diff] [--record file] [--book file] [--eval file]
+bool parseGameOptions(int argc, char** argv, GameOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        if (option == "--computer" || option == "--mcts") {
+            std::istringstream stream(value);
+            std::string seat;
+            while (std::getline(stream, seat, ',')) {
+                const int index = std::atoi(seat.c_str()) - 1;
+                if (index < 0 || index >= GameState::kPlayerCount) {
+                    return false;
+                }
+                options.seats[index] = option == "--mcts" ? SeatType::MonteCarlo : SeatType::Computer;
+            }
+        } else if (option == "--time") {
+            options.search.timeMillis = std::atoi(value.c_str());
+            if (options.search.timeMillis < 0) {
+                return false;
+            }
+        } else if (option == "--depth") {
+            options.search.maxDepth = std::atoi(value.c_str());
+            if (options.search.maxDepth < 1) {
+                return false;
+            }
+        } else if (option == "--render") {
+            if (value == "full") {
+                options.render = BoardRenderer::Mode::Full;
+            } else if (value == "skip") {
+                options.render = BoardRenderer::Mode::SkipUnchanged;
+            } else if (value == "diff") {
+                options.render = BoardRenderer::Mode::Diff;
+            } else {
+                return false;
+            }
+        } else if (option == "--record") {
+            options.recordPath = value;
+        } else if (option == "--book") {
+            options.bookPath = value;
+        } else if (option == "--eval") {
+            options.evalPath = value;
+        } else if (option == "--threads") {
+            options.search.threads = std::atoi(value.c_str());
+            if (options.search.threads < 1) {
+                return false;
+            }
+        } else if (option == "--hash") {
+            const int megabytes = std::atoi(value.c_str());
+            if (megabytes < 1) {
+                return false;
+            }
+            options.hashMegabytes = static_cast<std::size_t>(megabytes);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "perft") {
+        return runPerftCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return runBenchCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "arena") {
+        return runArenaCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "mcts-bench") {
+        return runMctsBenchCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "path-bench") {
+        return runPathBenchCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "endgame-bench") {
+        return runEndgameBenchCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "nnue") {
+        return runNnueCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "replay") {
+        return runReplayCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "archive") {
+        return runArchiveCommand(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "book") {
+        return runBookCommand(argc - 2, argv + 2);
+    }
+
+    GameOptions options;
+    if (!parseGameOptions(argc, argv, options)) {
+        std::cout << "usage: project2 [--computer seats] [--mcts seats] [--time ms] [--depth n] [--threads n] [--hash MB]\n"
+                  << "                [--render full|skip|diff] [--record file] [--book file] [--eval file]\n"
+                  << "       project2 perft [depth [position]]\n"
+                  << "       project2 perft --size 5|7|9|11 <depth>\n"
+                  << "       project2 bench [ms [threads [hash MB]]]\n"
+                  << "       project2 arena [options]\n"
+                  << "       project2 mcts-bench [ms [max threads]]\n"
+                  << "       project2 path-bench [positions]\n"
+                  << "       project2 endgame-bench [positions]\n"
+                  << "       project2 replay <record file>\n"
+                  << "       project2 archive build <out> [--run-entries n] <record files...>\n"
+                  << "       project2 archive query <archive> [position]\n"
+                  << "       project2 book build <out> [--plies n] [--min-games n] <record files...>\n"
+                  << "       project2 book probe <book> [position]\n"
+                  << "       project2 nnue train <out> [--epochs n] [--rate r] <record files...>\n"
+                  << "       project2 nnue bench [network]\n";
+        return 1;
+    }
 
-int main() {
-    Game game;
+    Game game(options);
     game.start();
     return 0;
 }